@@ -11,6 +11,43 @@
 // set in the control register, an interrupt will be triggered when either
 // a packet arrives or when one is finished transmitting. The IO address space
 // used is 8 bytes. Here is an example IO map. All registers are 8 bit and r/w
+//
+// The receive buffer is a ring of 4 frame slots of 2K bytes each. The line 
+// side fills the slot at the head and moves the head on when the frame is 
+// complete, the CPU reads the frame at the tail and writing the Receive 
+// Status register hands the slot back and moves the tail on. Frames that 
+// arrive with all 4 slots in use are dropped and the overrun bit is set.
+// The receive interrupt is a pulse for each frame put in the ring.
+//
+// The buffer address registers are auto-incrementing pointers. Load the 
+// pointer once through the Control (MSB) and Address (LSB) registers, then
+// each access to the Data register moves the pointer on by one, so a whole
+// frame can be copied with back to back IN or OUT instructions. The number 
+// of bytes written to the transmit buffer is the length of the frame sent.
+//
+// The Data registers are also 16 bits wide. A word access (IN AX,DX or
+// OUT DX,AX) to Base + 0x02 or Base + 0x06 moves two bytes of the transmit 
+// or receive buffer at once, low byte first, and moves the pointer on by two.
+// Keep the pointer even for word accesses, an odd byte at the end of a 
+// frame goes through the byte wide Data register as usual.
+//
+// The MAC looks after the Ethernet FCS (CRC32). With FTFCS set in the 
+// Transmit Control register the 4 FCS bytes are worked out on the fly and
+// sent after the last byte loaded, the CRC covers everything after the 8 
+// bytes of preamble and SFD. On receive the CRC of every frame is checked 
+// as it comes in, and FRBAD in the Receive Status register flags a frame at
+// the tail whose FCS did not match. The FCS is still left in the buffer.
+//
+// The receiver can drop frames that are not for us before they take a slot
+// in the ring. With FRFLT set in the Receive Control register a frame is 
+// only kept if its destination is our MAC address, broadcast, or a group 
+// address whose bit is set in the 64 bit multicast hash. The hash index is
+// bits 31:26 of the CRC register after the 6 destination bytes, the same 
+// CRC as the FCS, not complemented. The 14 byte filter table is loaded 
+// through the Receive Data register with FRSET set, the pointer picks the
+// byte, one at a time: 0-5 our MAC address, 6-13 the hash, bit n of it is 
+// bit n%8 of byte 6+n/8. Load it with FRRCV clear and set the pointer back
+// to 0 after. The table is not reset, so set it up before FRFLT.
 // 
 // I/O Address  Description
 // -----------  -----------------------------------------
@@ -50,18 +87,20 @@ module WB_Ethernet(
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 reg   [7:0]  dat_o;
-assign       wb_dat_o    =  wb_sel_i[0] ? {8'h00, dat_o} : {dat_o, 8'h00}; // 8 to 16 bit WB
+reg   [15:0] dat_w;										// Word read from a buffer
+wire         word_acc    = &wb_sel_i;      				// 16 bit access, Data registers only
+assign       wb_dat_o    =  word_acc ? dat_w : wb_sel_i[0] ? {8'h00, dat_o} : {dat_o, 8'h00}; // 8 to 16 bit WB
 wire   [7:0] dat_i       =  wb_sel_i[0] ? wb_dat_i[7:0]  : wb_dat_i[15:8]; // 8 to 16 bit WB
-wire   [2:0] wb_net_addr = {wb_adr_i,   wb_sel_i[1]};  	// Interface Address
+wire   [2:0] wb_net_addr = {wb_adr_i,   wb_sel_i[1]};  	// Interface Address, word goes to Data
 wire         wb_ack_i    =  wb_stb_i &  wb_cyc_i;      	// Immediate ack
-wire         wr_command  =  wb_ack_i &  wb_we_i;       	// Wishbone write access, Singal to send
-wire         rd_command  =  wb_ack_i & ~wb_we_i;       	// Wishbone write access, Singal to send
+wire         wb_access   =  wb_ack_i & ~wb_ack_o;      	// First clock of a bus cycle only
+wire         wr_command  =  wb_access &  wb_we_i;      	// Wishbone write access, Singal to send
+wire         rd_command  =  wb_access & ~wb_we_i;      	// Wishbone write access, Singal to send
 assign       wb_tgc_o    =  intr;                      	// Received interupts ocurred
-wire         intr  		=   1'b0;        				// Interupt Line
 
 always @(posedge wb_clk_i or posedge wb_rst_i) begin    // Synchrounous
     if(wb_rst_i) wb_ack_o <= 1'b0;
-    else         wb_ack_o <= wb_ack_i; // one clock delay on acknowledge output
+    else         wb_ack_o <= wb_ack_i & ~wb_ack_o; // one clock delay on acknowledge output
 end
 
 //-------------------------------------------------------------------------------------------------
@@ -85,30 +124,34 @@ end
 //   | | | | | `------ A10     - Address Bit 10 of buffer 
 //   | | | | `-------- 0       - Not used, reads zero
 //   | | | `---------- 0       - Not used, reads zero
-//   | | `------------ 0       - Not used, reads zero
+//   | | `------------ FTFCS   - Append the FCS to the frame when it is sent
 //   | `-------------- FTINT   - Allow Interrupt to be generated on completion of frame transmit
-//   `---------------- FTSND   - Send contents of transmit buffer now
+//   `---------------- FTSND   - Send contents of transmit buffer now, the address bits
+//                               are ignored on this write so the pointer holds the length
 //
 //
-//  |7|6|5|4|3|2|1|0|  Receive Status Register, writting anything to this register clears bit7, FRCVD
-//   | | | | | | | `-- 0       - Not used, reads zero
-//   | | | | | | `---- 0       - Not used, reads zero
-//   | | | | | `------ 0       - Not used, reads zero 
-//   | | | | `-------- 0       - Not used, reads zero 
-//   | | | `---------- 0       - Not used, reads zero 
-//   | | `------------ 0       - Not used, reads zero 
+//  |7|6|5|4|3|2|1|0|  Receive Status Register, writting anything to this register releases the
+//   | | | | | | | |                       frame at the tail, clears FROVR and sets the pointer to 0
+//   | | | | | | | `-- TAIL0   - Ring slot the CPU is reading, bit 0
+//   | | | | | | `---- TAIL1   - Ring slot the CPU is reading, bit 1
+//   | | | | | `------ HEAD0   - Ring slot the line is filling, bit 0
+//   | | | | `-------- HEAD1   - Ring slot the line is filling, bit 1
+//   | | | `---------- FRBAD   - The frame at the tail failed the FCS check
+//   | | `------------ FROVR   - A frame was dropped because the ring was full
 //   | `-------------- FRRX    - Indicates a complete Ethernet frameis being received, but no in yet
-//   `---------------- FRCVD   - Indicates a complete Ethernet frame was, 0 if no frame waiting 
+//   `---------------- FRCVD   - Indicates a complete Ethernet frame is at the tail, 0 if ring empty 
 //
-//  |7|6|5|4|3|2|1|0|  Receive Control Register
+//  |7|6|5|4|3|2|1|0|  Receive Control Register, reads back length bits 10:8 of the tail frame
 //   | | | | | | | `-- A08     - Address Bit  8 of buffer 
 //   | | | | | | `---- A09     - Address Bit  9 of buffer 
 //   | | | | | `------ A10     - Address Bit 10 of buffer 
-//   | | | | `-------- 0       - Not used, reads zero
-//   | | | `---------- 0       - Not used, reads zero
+//   | | | | `-------- FRSET   - Writes to the Data register load the address filter table
+//   | | | `---------- FRFLT   - Drop frames not for our address, broadcast or a hashed group
 //   | | `------------ 0       - Not used, reads zero
 //   | `-------------- FRINT   - Allow Interrupt to be generated on receipt of new frame
-//   `---------------- FRRCV   - Allow a frame to be receive into buffer, set to 0 to hold while processing
+//   `---------------- FRRCV   - Allow frames to be received into the ring
+//
+//  The Receive Address register reads back length bits 7:0 of the tail frame.
 //
 //-------------------------------------------------------------------------------------------------
   
@@ -116,46 +159,63 @@ end
 `define REG_TX_STAT     3'h0      // R/W  - Transmit Status
 `define REG_TX_CNTL     3'h1      // R/W  - Transmit Control + MSB Address
 `define REG_TX_ADDR     3'h2      // Transmit Buffer LSB Address Register 
-`define REG_TX_DATA     3'h3      // Transmit Buffer Data Register 
+`define REG_TX_DATA     3'h3      // Transmit Buffer Data Register, auto-increment
 `define REG_RX_STAT     3'h4      // Receive  Status  Register  
 `define REG_RX_CNTL     3'h5      // Receive  Control and MSB Address Register 
 `define REG_RX_ADDR     3'h6      // Receive  Buffer LSB Address Register 
-`define REG_RX_DATA     3'h7      // Receive  Buffer Data Register 
+`define REG_RX_DATA     3'h7      // Receive  Buffer Data Register, auto-increment
 
 //-------------------------------------------------------------------------------------------------
 // Register behavior
 //-------------------------------------------------------------------------------------------------
 reg			 FSENT;   	// Indicates a complete Ethernet frame was sent, reset to 0 if new frame loaded
-reg			 FRCVD;  	// Indicates a complete Ethernet frame was receved, reset to 0 if new frame loaded
-reg          FEOF;		// end of frame signal
+reg			 FROVR;  	// Indicates a frame was dropped because the receive ring was full
+wire		 FRCVD       = (rx_head_s != rx_tail);	// Indicates a complete Ethernet frame is waiting
 wire		 FTTX        =  SendingPacket;      // Indicates an Ethernet frame is being sent, but is not done yet
-wire		 FRRX        = ~end_of_frame;  		// Indicates an Ethernet frame is being received, but is not done yet
+wire		 FRRX        =  rx_active;  		// Indicates an Ethernet frame is being received, but is not done yet
 wire 		 FTSND 		 =  tx_control[7];		// Trigger to send a frame 
+wire 		 FTINT 		 =  tx_control[6];		// Interrupt when a frame is sent
+wire 		 FTFCS 		 =  tx_control[5];		// Append the FCS when a frame is sent
+wire		 FRBAD       =  FRCVD & rx_bad[rx_tail[1:0]];	// The frame at the tail has a bad FCS
+wire 		 FRINT 		 =  rx_control[6];		// Interrupt when a frame is received
 wire 		 FRRCV 		 =  rx_control[7];		// Allow a frame to be received
+wire 		 FRSET 		 =  rx_control[3];		// Data register writes go to the filter table
+wire 		 FRFLT 		 =  rx_control[4];		// Drop frames that are not for us
 wire [7:0]   tx_status   = {FSENT, FTTX, 6'h00};
-wire [7:0]   rx_status	 = {FEOF,  FRRX, FRCVD, DR_risingedge, 4'b0000};
+wire [7:0]   rx_status	 = {FRCVD, FRRX, FROVR, FRBAD, rx_head_s[1:0], rx_tail[1:0]};
+wire [10:0]  rx_length   = rx_len[rx_tail[1:0]];	// Length of the frame at the tail
 reg  [7:0]   tx_control;
 reg  [7:0]   rx_control;
-reg  [7:0]   tx_address;
-reg  [7:0]   rx_address;
-wire [7:0]   tx_buffer	= dat_i;
-wire [7:0]   rx_buffer	= dat_i;
+reg  [10:0]  tx_ptr;						// CPU side transmit buffer pointer
+reg  [10:0]  rx_ptr;						// CPU side receive  buffer pointer
+wire [10:0]  ptr_inc    = word_acc ? 11'd2 : 11'd1;	// Pointer step, two for a word
+wire         tx_wr      = wr_command && (wb_net_addr == `REG_TX_DATA);	// Write a byte to the Tx buffer
+wire         rx_wr      = wr_command && (wb_net_addr == `REG_RX_DATA);	// Write a byte to the Rx buffer
+wire         tx_rd      = rd_command && (wb_net_addr == `REG_TX_DATA);	// Read a byte from the Tx buffer
+wire         rx_rd      = rd_command && (wb_net_addr == `REG_RX_DATA);	// Read a byte from the Rx buffer
 
 always @(posedge wb_clk_i or posedge wb_rst_i) begin // Synchrounous Logic
   if(wb_rst_i) begin
 	dat_o   	 <= 8'h00;                         	// Default value
+	dat_w   	 <= 16'h0000;                      	// Default value
   end 
   else begin
      if(rd_command) begin                           // If a read was requested
         case(wb_net_addr)                           // Determine which register was read
             `REG_TX_STAT: dat_o <= tx_status;       // Read Tx status register
-            `REG_TX_CNTL: dat_o <= tx_control;      // Read back the control register
-            `REG_TX_ADDR: dat_o <= tx_address;      // Read back the address register
-            `REG_TX_DATA: dat_o <= tx_rd_buf;       // Read the Tx Data register
+            `REG_TX_CNTL: dat_o <= {tx_control[7:3],tx_ptr[10:8]};      // Read back the control register
+            `REG_TX_ADDR: dat_o <= tx_ptr[7:0];     // Read back the address register
+            `REG_TX_DATA: begin						// Read the Tx Data register
+					dat_o <= tx_ptr[0] ? tx_rd_odd : tx_rd_even;
+					dat_w <= {tx_rd_odd, tx_rd_even};
+				end
             `REG_RX_STAT: dat_o <= rx_status;       // Read Rx status register
-            `REG_RX_CNTL: dat_o <= {rx_control[7:3],rxaddr[10:8]};      // Read back the control register
-            `REG_RX_ADDR: dat_o <= rxaddr[7:0];      // Read back the address register
-            `REG_RX_DATA: dat_o <= rx_rd_buf;       // Read the Tx Data register
+            `REG_RX_CNTL: dat_o <= {rx_control[7:3],rx_length[10:8]};   // Read back the control register
+            `REG_RX_ADDR: dat_o <= rx_length[7:0];  // Read back the length of the tail frame
+            `REG_RX_DATA: begin						// Read the Rx Data register
+					dat_o <= rx_ptr[0] ? rx_rd_odd : rx_rd_even;
+					dat_w <= {rx_rd_odd, rx_rd_even};
+				end
             default:      dat_o <= 8'h00;           // Default
         endcase                                     // End of case
      end                                            // End if read
@@ -166,83 +226,162 @@ always @(posedge wb_clk_i or posedge wb_rst_i) begin  // Synchrounous Logic
   if(wb_rst_i) begin
     tx_control <=  8'h00;                   		// not on
     rx_control <=  8'h00;                   		// not on
+	tx_ptr		 <= 11'h000;						// Start of buffer
+	rx_ptr		 <= 11'h000;						// Start of buffer
+	rx_tail		 <=  3'b000;						// Ring is empty
 	FSENT		 <=  1'b0;                   		// not on
-	FRCVD		 <=  1'b0;                   		// not on
-	wren_tx 	 <=  1'b0;							// Not writting to buffer
-	wren_rx 	 <=  1'b0;							// Not writting to buffer
+	FROVR		 <=  1'b0;                   		// not on
 	StartSending <= 1'b0;							// Not Send a byte
   end 
   else begin
 	if(wr_command) begin                           // If a write was requested
         case(wb_net_addr)                           // Determine which register was writen to
             `REG_TX_STAT: FSENT		 <=  1'b0;      // Tx status register, clear interrupt flag
-            `REG_TX_CNTL: tx_control <= dat_i;      // Read back the control register
-            `REG_TX_ADDR: tx_address <= dat_i;      // Read back the address register
-            `REG_TX_DATA: wren_tx    <=  1'b1;      // Write to the Tx Buffer
-            `REG_RX_STAT: FRCVD		 <=  1'b0;      // Rx status register, clear  flag
-            `REG_RX_CNTL: rx_control <= dat_i;      // Read back the control register
-            `REG_RX_ADDR: rx_address <= dat_i;      // Read back the address register
-            `REG_RX_DATA: wren_rx    <=  1'b1;      // Write to the Rx Buffer
+            `REG_TX_CNTL: begin						// Control register
+					tx_control <= dat_i;
+					if(dat_i[7]) FSENT <= 1'b0;			// Sending, pointer holds the length
+					else         tx_ptr[10:8] <= dat_i[2:0];
+				end
+            `REG_TX_ADDR: tx_ptr[7:0] <= dat_i;     // Set the pointer LSB
+            `REG_TX_DATA: tx_ptr <= tx_ptr + ptr_inc; // Written, on to the next one
+            `REG_RX_STAT: begin						// Rx status register, done with the frame
+					if(FRCVD) rx_tail <= rx_tail + 3'd1;	// hand the slot back
+					rx_ptr <= 11'h000;						// next frame starts at 0
+					FROVR  <= 1'b0;							// clear the overrun flag
+				end
+            `REG_RX_CNTL: begin						// Control register
+					rx_control   <= dat_i;
+					rx_ptr[10:8] <= dat_i[2:0];
+				end
+            `REG_RX_ADDR: rx_ptr[7:0] <= dat_i;     // Set the pointer LSB
+            `REG_RX_DATA: rx_ptr <= rx_ptr + ptr_inc; // Written, on to the next one
             default: ;                              // Default value                        
         endcase                                     // End of case
     end                                             // End of Write Command if
-	else begin
-		wren_tx <= 1'b0;      						// Done Writting to the Tx Buffer
-		wren_rx <= 1'b0;      						// Done Writting to the Rx Buffer
-	end
+
+	if(tx_rd) tx_ptr <= tx_ptr + ptr_inc;		// Read, on to the next one
+	if(rx_rd) rx_ptr <= rx_ptr + ptr_inc;		// Read, on to the next one
 	
     if(FTSND) begin 
-		FSENT <= 1'b0;							// Reset the Frame Sent flag
-		if(FTTX) tx_control[7] <= 1'b0;
+		if(FTTX) tx_control[7] <= 1'b0;			// Transmitter has it, drop the trigger
 		StartSending  <= 1'b1;						// Send a byte
 	end
 	else StartSending <= 1'b0;
-	if(!FTTX && !FSENT) FSENT <= 1'b1;				// Set the Frame Sent flag
-
-	if(FEOF) begin
-		FRCVD <= 1'b1;							// Set the Frame receive flag
-	end
+	if(tx_done) FSENT <= 1'b1;						// Set the Frame Sent flag
+	if(rx_dropped) FROVR <= 1'b1;					// Set the overrun flag
 		
   end                                               // End of Reset if
 end                                                     
 
+//-------------------------------------------------------------------------------------------------
+// Address filter table, our MAC address in 0-5 and the multicast hash in 6-13
+//-------------------------------------------------------------------------------------------------
+reg  [7:0]   rx_filt[0:13];
+always @(posedge wb_clk_i)
+	if(rx_wr && FRSET && (rx_ptr[10:4] == 7'd0) && (rx_ptr[3:0] < 4'd14)) rx_filt[rx_ptr[3:0]] <= dat_i;
+
+//-------------------------------------------------------------------------------------------------
+// Interrupt, a one clock pulse for each frame put in the ring or sent
+//-------------------------------------------------------------------------------------------------
+reg          intr;
+always @(posedge wb_clk_i or posedge wb_rst_i) begin
+	if(wb_rst_i) intr <= 1'b0;
+	else         intr <= (FRINT & rx_new) | (FTINT & tx_done);
+end
+
+//-------------------------------------------------------------------------------------------------
+// CRC32 of one more byte, the Ethernet polynomial bit reversed, LSB first 
+// as the bits go out on the wire. Start from all ones, the FCS sent is the 
+// complement, and running the CRC over a good frame and its FCS leaves the
+// magic residue 0xDEBB20E3.
+//-------------------------------------------------------------------------------------------------
+function [31:0] crc32_byte;
+	input [31:0] crc;
+	input [ 7:0] d;
+	integer      i;
+	reg   [31:0] c;
+	begin
+		c = crc;
+		for(i = 0; i < 8; i = i + 1)
+			c = (c[0] ^ d[i]) ? {1'b0, c[31:1]} ^ 32'hEDB88320 : {1'b0, c[31:1]};
+		crc32_byte = c;
+	end
+endfunction
+
 //-------------------------------------------------------------------------------------------------
 // Transmit Section
 //-------------------------------------------------------------------------------------------------
-wire [10:0] txrwaddr = {tx_control[2:0],tx_address};
+// The buffers are split into even and odd byte banks so a word access can 
+// reach both bytes in one clock, the line side takes them a byte at a time.
+//-------------------------------------------------------------------------------------------------
 reg  [10:0] txaddr;
-wire [ 7:0] tx_rd_buf;
-reg			wren_tx;
-ram2 txram(.clock_a(wb_clk_i),.address_a(txrwaddr),.data_a(tx_buffer),.q_a(tx_rd_buf),.wren_a(wren_tx&wb_stb_i),
-		   .clock_b(clk20),   .address_b(txaddr),                     .q_b(TxData),   .wren_b(1'b0));
-
-wire [10:0] wrtotal = txrwaddr;
+wire [ 7:0] tx_rd_even, tx_rd_odd;
+wire [ 7:0] TxEven, TxOdd;
+wire [ 7:0] TxData;
+wire [ 7:0] TxBuf;
+wire [ 7:0] tx_even_i = word_acc ? wb_dat_i[ 7:0] : dat_i;
+wire [ 7:0] tx_odd_i  = word_acc ? wb_dat_i[15:8] : dat_i;
+eth_ram txeven(.clock_a(wb_clk_i),.address_a(tx_ptr[10:1]),.data_a(tx_even_i),.q_a(tx_rd_even),.wren_a(tx_wr & (word_acc | ~tx_ptr[0])),
+		       .clock_b(clk20),   .address_b(txaddr[10:1]),.data_b(8'h00),    .q_b(TxEven),    .wren_b(1'b0));
+eth_ram txodd (.clock_a(wb_clk_i),.address_a(tx_ptr[10:1]),.data_a(tx_odd_i), .q_a(tx_rd_odd), .wren_a(tx_wr & (word_acc |  tx_ptr[0])),
+		       .clock_b(clk20),   .address_b(txaddr[10:1]),.data_b(8'h00),    .q_b(TxOdd),     .wren_b(1'b0));
+assign      TxBuf  = txaddr[0] ? TxOdd : TxEven;
+
+wire [10:0] wrtotal = tx_ptr;					// bytes loaded is the frame length
+wire [10:0] txtotal = FTFCS ? wrtotal + 11'd4 : wrtotal;	// plus the FCS if we make it
 reg 		StartSending;
 reg 		SendingPacket;
-always @(posedge clk20) if(StartSending) SendingPacket <= 1'b1; else if(NextByte && txaddr == wrtotal) SendingPacket <= 1'b0;
+always @(posedge clk20) if(StartSending) SendingPacket <= 1'b1; else if(NextByte && txaddr == txtotal) SendingPacket <= 1'b0;
 always @(posedge clk20) if(NextByte) txaddr <= SendingPacket ? txaddr +  11'd1 : 11'd0;
 
+//-----------------------------------------------------------------------------
+// FCS, the CRC runs over the bytes after the preamble and SFD as they are 
+// loaded into the shifter, then its complement goes out low byte first
+//-----------------------------------------------------------------------------
+reg  [31:0] tx_crc;
+wire        tx_infcs = (txaddr >= wrtotal);		// past the loaded bytes
+wire [ 1:0] tx_fcsb  = txaddr[1:0] - wrtotal[1:0];	// which FCS byte
+wire [31:0] tx_fcs   = ~tx_crc;
+always @(posedge clk20) 
+	if(NextByte) begin
+		if(txaddr < 11'd8) tx_crc <= 32'hFFFFFFFF;	// preamble and SFD
+		else if(!tx_infcs) tx_crc <= crc32_byte(tx_crc, TxBuf);
+	end
+assign      TxData = !tx_infcs       ? TxBuf        :
+                     tx_fcsb == 2'd0 ? tx_fcs[ 7: 0] :
+                     tx_fcsb == 2'd1 ? tx_fcs[15: 8] :
+                     tx_fcsb == 2'd2 ? tx_fcs[23:16] : tx_fcs[31:24];
+
+//-----------------------------------------------------------------------------
+// Frame is done when the transmitter drops SendingPacket, bring it over to 
+// the wishbone clock and look for the falling edge
+//-----------------------------------------------------------------------------
+reg  [2:0]  TXedge;
+always @(posedge wb_clk_i) TXedge <= {TXedge[1:0], SendingPacket};
+wire        tx_done = (TXedge[2:1] == 2'b10);
+
 wire		NextByte;
-wire [7:0]  TxData;
 TENBASET_TxD U1(.clk20(clk20), .Ethernet_Tx(Ethernet_Tx), .TxData(TxData), .SendingPacket(SendingPacket), .NextByte(NextByte)); 
 
 	
 //-------------------------------------------------------------------------------------------------
 // Receive Section
 //-------------------------------------------------------------------------------------------------
-wire [10:0] rxwraddr = {rx_control[2:0],rx_address};
-wire [ 7:0] rx_rd_buf;
-reg			wren_rx;
-ram2 rxram(.clock_a(wb_clk_i),.address_a(rxwraddr), .data_a(rx_buffer),.q_a(rx_rd_buf),.wren_a(wren_rx&wb_stb_i),
-		   .clock_b(clk50),   .address_b(rxaddr),   .data_b(RxData),                   .wren_b(wren_rb));
+// The ring slot is the top of the buffer address, the CPU reads the slot at
+// the tail and the line fills the slot at the head. Each pointer carries a 
+// wrap bit so full and empty can be told apart, and crosses to the other 
+// clock in gray code.
+//-------------------------------------------------------------------------------------------------
+wire [ 7:0] rx_rd_even, rx_rd_odd;
+wire [ 7:0] rx_even_i = word_acc ? wb_dat_i[ 7:0] : dat_i;
+wire [ 7:0] rx_odd_i  = word_acc ? wb_dat_i[15:8] : dat_i;
+wire [11:0] rx_cpu_a  = {rx_tail[1:0], rx_ptr[10:1]};
+wire [11:0] rx_lin_a  = {rx_head[1:0], rx_count[10:1]};
+eth_ram #(.aw(12)) rxeven(.clock_a(wb_clk_i),.address_a(rx_cpu_a),.data_a(rx_even_i),.q_a(rx_rd_even),.wren_a(rx_wr & ~FRSET & (word_acc | ~rx_ptr[0])),
+		                  .clock_b(clk50),   .address_b(rx_lin_a),.data_b(RxData),   .q_b(),          .wren_b(wren_rb & ~rx_count[0]));
+eth_ram #(.aw(12)) rxodd (.clock_a(wb_clk_i),.address_a(rx_cpu_a),.data_a(rx_odd_i), .q_a(rx_rd_odd), .wren_a(rx_wr & ~FRSET & (word_acc |  rx_ptr[0])),
+		                  .clock_b(clk50),   .address_b(rx_lin_a),.data_b(RxData),   .q_b(),          .wren_b(wren_rb &  rx_count[0]));
 
-//-----------------------------------------------------------------------------
-// Find Rising edge of end_of_frame line using a 3-bits shift register
-//-----------------------------------------------------------------------------
-reg [2:0] DRedge;  
-always @(posedge clk50) DRedge <= {DRedge[1:0], end_of_frame};
-wire DR_risingedge  = (DRedge[2:1] == 2'b01);      // now we can detect DR rising edge
-		   
 wire        new_byte;
 wire        sync_pulse;
 wire		end_of_frame;
@@ -252,47 +391,122 @@ reg			wren_rb;
 TENBASET_RxD rx1(.clk48(clk50),.manchester_data_in(Ethernet_Rx),.RxData(RxData), 
 					.new_byte_available(new_byte), .sync_pulse(sync_pulse), .end_of_frame(end_of_frame));
 
-//wire        rcv_ready = (!FRCVD && FRRCV);
-reg  [10:0] rxaddr;
-reg         isreceiving;
-reg         incaddr;
+//-----------------------------------------------------------------------------
+// Ring pointers, gray code conversion and synchronizers
+//-----------------------------------------------------------------------------
+reg  [ 2:0] rx_head;						// Slot being filled, line side
+reg  [ 2:0] rx_head_g;						// Same in gray code
+reg  [ 2:0] rx_tail;						// Slot being read, wishbone side
+wire [ 2:0] rx_tail_g = rx_tail ^ {1'b0, rx_tail[2:1]};
+reg  [10:0] rx_len[0:3];					// Length of the frame in each slot
+reg  [ 3:0] rx_bad;							// FCS check failed, one per slot
+
+reg  [ 2:0] HEADs1, HEADs2, HEADs3;			// head over to the wishbone clock
+always @(posedge wb_clk_i) {HEADs3, HEADs2, HEADs1} <= {HEADs2, HEADs1, rx_head_g};
+wire [ 2:0] rx_head_s = {HEADs2[2], ^HEADs2[2:1], ^HEADs2};
+wire        rx_new    = (HEADs3 != HEADs2);	// a frame went into the ring
+
+reg  [ 2:0] TAILs1, TAILs2;					// tail over to the line clock
+always @(posedge clk50) {TAILs2, TAILs1} <= {TAILs1, rx_tail_g};
+wire [ 2:0] rx_tail_s = {TAILs2[2], ^TAILs2[2:1], ^TAILs2};
+
+reg  [ 1:0] ENs;							// receive enable over to the line clock
+always @(posedge clk50) ENs <= {ENs[0], FRRCV};
+reg  [ 1:0] FLTs;							// filter enable over to the line clock
+always @(posedge clk50) FLTs <= {FLTs[0], FRFLT};
+
+reg         rx_drop_t;						// toggles for every frame dropped
+reg  [ 2:0] DROPs;							// and over to the wishbone clock
+always @(posedge wb_clk_i) DROPs <= {DROPs[1:0], rx_drop_t};
+wire        rx_dropped = DROPs[2] ^ DROPs[1];
+
+//-----------------------------------------------------------------------------
+// Find Rising edge of sync_pulse, that is the end of the frame on the wire
+//-----------------------------------------------------------------------------
+reg [1:0] EOFedge;  
+always @(posedge clk50) EOFedge <= {EOFedge[0], sync_pulse};
+wire rx_eof  = (EOFedge == 2'b01);
+
+//-----------------------------------------------------------------------------
+// Destination filter, the first 6 bytes are looked at as they come in, 
+// whether or not there is a slot for the frame. The table is only written 
+// with the receiver off, so it is taken across to the line clock as it is.
+//-----------------------------------------------------------------------------
+reg  [ 2:0] rx_dst;							// Destination bytes seen, 7 once judged
+reg         rx_ucast;						// Destination is our address so far
+reg         rx_bcast;						// Destination is all ones so far
+reg         rx_group;						// Destination is a group address
+reg  [31:0] rx_hcrc;						// CRC of the destination, for the hash
+reg         rx_byte;						// new_byte a clock on, RxData is steady
+wire [ 5:0] rx_hash    = rx_hcrc[31:26];
+wire [ 7:0] rx_hbyte   = rx_filt[4'd6 + rx_hash[5:3]];
+wire        rx_pass    = ~FLTs[1] | rx_ucast | rx_bcast | (rx_group & rx_hbyte[rx_hash[2:0]]);
+
+//-----------------------------------------------------------------------------
+// Line side, fill the head slot and move the head on at the end of frame
+//-----------------------------------------------------------------------------
+reg  [10:0] rx_count;						// Bytes in the frame so far
+reg         rx_active;						// A frame is coming in
+reg         rx_want;						// Receiving was on when it started
+reg         rx_keep;						// There was a slot free for it
+reg  [31:0] rx_crc;							// CRC of the frame so far, FCS and all
+wire        rx_full    = (rx_head[2] != rx_tail_s[2]) && (rx_head[1:0] == rx_tail_s[1:0]);
+wire        rx_take    = rx_active ? rx_keep : (~rx_full & ENs[1]);
+wire [ 2:0] rx_head_nx = rx_head + 3'd1;
 
 always @(posedge clk50) begin
 	if(wb_rst_i) begin
-		rxaddr 		<= 11'h000;           	// Default value
-		FEOF		<= 1'b0;				// No new frame
-		isreceiving	<= 1'b0;				// Not Receiving
+		rx_head		<= 3'b000;				// Ring is empty
+		rx_head_g	<= 3'b000;				// Ring is empty
+		rx_count	<= 11'h000;           	// Default value
+		rx_active	<= 1'b0;				// Not Receiving
+		rx_want		<= 1'b0;				// Not Receiving
+		rx_keep		<= 1'b0;				// Not Receiving
+		rx_dst		<= 3'd0;				// No destination yet
+		rx_byte		<= 1'b0;				// No byte yet
+		rx_drop_t	<= 1'b0;				// Nothing dropped
 		wren_rb 	<= 1'b0;				// Not writting to buffer
-		incaddr 	<= 1'b0;				// signal to increment buffer address
 	end 
 	else begin
+		wren_rb <= new_byte & rx_take & (rx_count != 11'h7FF);	// write the byte, if it fits
+		if(wren_rb) rx_count <= rx_count + 11'd1;				// receive next byte in frame
+		if(!rx_active) rx_crc <= 32'hFFFFFFFF;					// CRC starts from all ones
+		else if(wren_rb) rx_crc <= crc32_byte(rx_crc, RxData);	// and takes in every byte
+
+		rx_byte <= new_byte;
+		if(!rx_active) begin					// Destination starts over
+			rx_dst   <= 3'd0;
+			rx_ucast <= 1'b1;
+			rx_bcast <= 1'b1;
+			rx_hcrc  <= 32'hFFFFFFFF;
+		end
+		else if(rx_byte && (rx_dst < 3'd6)) begin	// One more destination byte
+			rx_dst   <= rx_dst + 3'd1;
+			rx_ucast <= rx_ucast & (RxData == rx_filt[rx_dst]);
+			rx_bcast <= rx_bcast & (RxData == 8'hFF);
+			if(rx_dst == 3'd0) rx_group <= RxData[0];
+			rx_hcrc  <= crc32_byte(rx_hcrc, RxData);
+		end
+		else if(rx_dst == 3'd6) begin			// All 6 in, is it for us?
+			rx_dst <= 3'd7;
+			if(!rx_pass) rx_keep <= 1'b0;		// no, it never takes the slot
+			else if(rx_want & ~rx_keep) rx_drop_t <= ~rx_drop_t;	// no room, tell the CPU
+		end
 
-		if(DR_risingedge) FEOF <= 1'b1;
-		
-		if(FRRCV)  begin 
-			FEOF   <= 1'b0;
-			rxaddr <= 11'h000;				// start transmitting new frame
+		if(new_byte && !rx_active) begin		// First byte of a new frame
+			rx_active <= 1'b1;
+			rx_want   <= ENs[1];
+			rx_keep   <= ~rx_full & ENs[1];
 		end
-		
-		if(!FEOF && !isreceiving) isreceiving <= 1'b1;
-		
-		if(isreceiving) begin
-			if(sync_pulse) begin				// New byte of data came in 
-				isreceiving <= 1'b0;			// Done receiving
-			end 
-			else begin
-				if(incaddr && !new_byte) begin
-					rxaddr <= rxaddr + 11'd1;	// receive next byte in frame
-					incaddr   <= 1'b0;
-				end
-				
-				if(new_byte) begin
-					wren_rb   <= 1'b1;
-					incaddr   <= 1'b1;
-				end
-				else begin
-					wren_rb   <= 1'b0;				// Not writting to buffer
-				end
+
+		if(rx_eof && rx_active) begin			// End of the frame
+			rx_active <= 1'b0;
+			rx_count  <= 11'h000;
+			if(rx_keep && (rx_count > 11'd17)) begin	// at least a header and FCS
+				rx_len[rx_head[1:0]] <= rx_count;
+				rx_bad[rx_head[1:0]] <= (rx_crc != 32'hDEBB20E3);	// good frames leave the residue
+				rx_head   <= rx_head_nx;
+				rx_head_g <= rx_head_nx ^ {1'b0, rx_head_nx[2:1]};
 			end
 		end
 	end
@@ -426,6 +640,39 @@ endmodule
 //-------------------------------------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+// Module:      eth_ram
+// Description: Dual clock, dual port packet buffer RAM, one byte wide.
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+module eth_ram #(
+	parameter aw = 10						// address width, 2^aw bytes
+  )
+  (
+	input				clock_a,			// Port A, wishbone side
+	input      [aw-1:0]	address_a,
+	input      [ 7:0]	data_a,
+	input				wren_a,
+	output reg [ 7:0]	q_a,
+	input				clock_b,			// Port B, line side
+	input      [aw-1:0]	address_b,
+	input      [ 7:0]	data_b,
+	input				wren_b,
+	output reg [ 7:0]	q_b
+  );
+  reg [7:0] mem[0:(1<<aw)-1];  				// Registers and nets
+  always @(posedge clock_a) begin
+	if(wren_a) mem[address_a] <= data_a;
+	q_a <= mem[address_a];
+  end
+  always @(posedge clock_b) begin
+	if(wren_b) mem[address_b] <= data_b;
+	q_b <= mem[address_b];
+  end
+
+endmodule
+
 //-------------------------------------------------------------------------------------------------
 // End of WB Ethernet Modules
 //-------------------------------------------------------------------------------------------------
@@ -87,7 +87,7 @@ always @(posedge wb_clk_i or posedge wb_rst_i) begin		// Synchrounous
         INTID 	<= 2'b00;          			// Interupt ID
     end
     else begin
-        if(DR & EDAI) begin     			// If enabled
+        if(rx_drdy & EDAI) begin     		// If enabled, once per byte
             IPEN  <= 1'b0;            		// Set latch (inverted)
             IPEND <= 1'b1;					// Indicates an Interupt is pending
             INTID <= 2'b10;           		// Set Interupt ID
@@ -150,6 +150,9 @@ always @(posedge wb_clk_i or posedge wb_rst_i) begin		// Synchrounous
         THRE  	<= 1'b0;					// Transmitter holding register is empty
     end
     else begin
+        if(rd_command && (UART_Addr == `UART_RG_TR) && !dlab)
+            DR    <= 1'b0;					// The byte has been read
+
         if(rx_drdy) begin     				// If enabled
             DR    <= 1'b1;					// Indicates data is waiting to be read
 			if(rx_rden) rx_read	<= 1'b1; 	// If reading enabled, request another byte 
@@ -179,7 +182,8 @@ wire RTS   = mcr[1];
 wire OUT1  = mcr[2];
 wire OUT2  = mcr[3];
 wire LOOP  = mcr[4];
-wire [7:0] MCON  = {3'b000, mcr[4:0]};
+wire [1:0] BMUL  = mcr[6:5];		// Baud x 1, 2, 4 or 8, not on an 8250
+wire [7:0] MCON  = {1'b0, mcr[6:0]};
 
 // --------------------------------------------------------------------
 // Wires for Modem Status Register (MSR)
@@ -203,7 +207,8 @@ wire dlab       = lcr[7];           // Data Latch Address Bit
 // --------------------------------------------------------------------
 //  8250A Registers
 // --------------------------------------------------------------------
-wire [7:0] output_data;        // Wired to receiver
+wire [7:0] output_data;        // Wired to receiver, changes as the next byte comes in
+reg  [7:0] rx_hold;            // Last whole byte received
 reg  [7:0] input_data;         // Transmit register
 reg  [3:0] ier;                // Interrupt enable register
 reg  [7:0] lcr;                // Line Control register
@@ -221,7 +226,7 @@ always @(posedge wb_clk_i or posedge wb_rst_i) begin		// Synchrounous
     else 
     if(rd_command) begin
         case(UART_Addr)                            // Determine which register was read
-            `UART_RG_TR: dat_o <= dlab ? dll : output_data;
+            `UART_RG_TR: dat_o <= dlab ? dll : rx_hold;
             `UART_RG_IE: dat_o <= dlab ? dlh : INTE;
             `UART_RG_II: dat_o <= ISTAT;        // Interupt ID
             `UART_RG_LC: dat_o <= LCON;         // Line control
@@ -257,6 +262,8 @@ always @(posedge wb_clk_i or posedge wb_rst_i) begin		// Synchrounous
     end
 end  // Synchrounous always
 
+always @(posedge wb_clk_i) if(rx_drdy) rx_hold <= output_data;
+
 // --------------------------------------------------------------------
 // Transmit behavior
 // --------------------------------------------------------------------
@@ -289,7 +296,7 @@ wire 		Baud1Tick = BaudAcc1[18];
 wire 		Baud8Tick = BaudAcc8[15];
 reg  [18:0] BaudAcc1;
 reg  [15:0] BaudAcc8;
-wire [18:0] BaudInc =  19'd2416/Baudiv;
+wire [18:0] BaudInc = (19'd2416 << BMUL)/Baudiv;	// 921600 at most
 always @(posedge wb_clk_i) BaudAcc1 <= BaudAcc1[17:0] + BaudInc;
 always @(posedge wb_clk_i) BaudAcc8 <= BaudAcc8[14:0] + BaudInc;
   
@@ -335,6 +342,12 @@ endmodule
 //  38400	   3  0.000%
 //  57600	   2  0.000%
 // 115200	   1  0.000%
+//
+// Above that the divisor is left at 1 and MCR bits 6:5 (BMUL) shift
+// the increment up, x2 230400, x4 460800, x8 921600. At x8 the 8x
+// receive tick is 7.4 MHz, still under one per clock. The received
+// byte is held in rx_hold, so it can be read for a whole character
+// time after DR comes up, 10.8 us at 921600.
 //  
 // --------------------------------------------------------------------
 
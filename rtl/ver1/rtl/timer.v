@@ -6,15 +6,37 @@
 //    Fo = Fc * N / 2^bits
 //    here N: 12507 and bits: 33
 //    it gives a frequency of 18.200080376 Hz
+//
+//    It also keeps a free running 32 bit microsecond counter that
+//    can be read on the wishbone bus, so software can time things to
+//    better than the 55 ms of the system tick. The microsecond tick
+//    is another phase accumulator, Fc * us_num / us_den, 12.5 MHz *
+//    2 / 25 = 1 MHz, each tick is within one clock of where it should
+//    be and they never drift. The count wraps after 71 minutes.
+//
+//    I/O Address  Description
+//    -----------  -----------------------------------------
+//    Base + 0x00  Microseconds, bits 15:0, reading it latches 31:16
+//    Base + 0x02  Microseconds, bits 31:16, as latched
+//
+//    Read the low word first and then the high one (16 bit IN AX,DX
+//    both times), the two halves are then from the same instant.
 // --------------------------------------------------------------------
 // --------------------------------------------------------------------
 module timer #(
-    parameter res   = 33,   // bit resolution (default: 33 bits)
-    parameter phase = 12507 // phase value for the counter
+    parameter res    = 33,    // bit resolution (default: 33 bits)
+    parameter phase  = 12507, // phase value for the counter
+    parameter us_num = 2,     // microsecond tick is Fc * us_num / us_den
+    parameter us_den = 25
   )
   (
     input      wb_clk_i,	  	// Wishbone slave interface
     input      wb_rst_i,
+    input      wb_adr_i,
+    output [15:0] wb_dat_o,
+    input      wb_stb_i,
+    input      wb_cyc_i,
+    output     wb_ack_o,
     output reg wb_tgc_o   		// Interrupt output
   );
 
@@ -22,8 +44,18 @@ module timer #(
   reg           old_clk2;
   wire          clk2;
 
+  reg     [7:0] us_acc;         // microsecond phase accumulator
+  reg    [31:0] us_cnt;         // microseconds since reset
+  reg    [15:0] us_hold;        // high half, latched by a low read
+  wire    [8:0] us_next;
+  wire          op;
+
   // Continuous assignments
-  assign clk2 = cnt[res-1];
+  assign clk2     = cnt[res-1];
+  assign us_next  = us_acc + us_num;
+  assign op       = wb_cyc_i & wb_stb_i;
+  assign wb_ack_o = op;
+  assign wb_dat_o = wb_adr_i ? us_hold : us_cnt[15:0];
 
   // Behaviour
   always @(posedge wb_clk_i)
@@ -35,6 +67,20 @@ module timer #(
   always @(posedge wb_clk_i)
     wb_tgc_o <= wb_rst_i ? 1'b0 : (!old_clk2 & clk2);
 
+  always @(posedge wb_clk_i)
+    if(wb_rst_i) begin
+      us_acc <= 8'd0;
+      us_cnt <= 32'd0;
+    end
+    else if(us_next >= us_den) begin
+      us_acc <= us_next - us_den;
+      us_cnt <= us_cnt + 32'd1;
+    end
+    else us_acc <= us_next[7:0];
+
+  always @(posedge wb_clk_i)
+    us_hold <= wb_rst_i ? 16'h0 : ((op & !wb_adr_i) ? us_cnt[31:16] : us_hold);
+
 // --------------------------------------------------------------------
 endmodule
 // --------------------------------------------------------------------
@@ -528,15 +528,6 @@ module zbc (
 	.PS2_MSE_CLK(ps2_mclk_),.PS2_MSE_DAT(ps2_mdat_)
   );  
   
-  // --------------------------------------------------------------------
-  // Super Simple Timer controller
-  // --------------------------------------------------------------------
-  timer #(.res(33), .phase (12507))  timer0 (
-    .wb_clk_i (clk),
-    .wb_rst_i (rst),
-    .wb_tgc_o (intv[0])
-  );
-
   // --------------------------------------------------------------------
   // Super Simple Priority Interupt controller
   //
@@ -634,7 +625,13 @@ module zbc (
   wire        gpio_cyc_i;			// GPIO controller
   wire        gpio_stb_i;			// GPIO controller
   wire        gpio_ack_o;			// GPIO controller  
+  wire [15:0] tmr_dat_o;			// Timer microsecond counter
+  wire        tmr_ack_o;
+  wire [15:0] io5_dat_o;			// GPIO or Timer, to the switch
+  wire        io5_ack_o;
   wire  [7:0] GPIO_Output; 
+  assign      io5_dat_o = gpio_adr_i[2] ? tmr_dat_o : gpio_dat_o;
+  assign      io5_ack_o = gpio_ack_o | tmr_ack_o;
   assign      GPIO_Out_ = GPIO_Output[1:0];
   gpio gpio1 (
     .wb_clk_i (clk),			// Wishbone slave interface
@@ -644,7 +641,7 @@ module zbc (
     .wb_dat_i (gpio_dat_i),
     .wb_sel_i (gpio_sel_i),
     .wb_we_i  (gpio_we_i),
-    .wb_stb_i (gpio_stb_i),
+    .wb_stb_i (gpio_stb_i & ~gpio_adr_i[2]),
     .wb_cyc_i (gpio_cyc_i),
     .wb_ack_o (gpio_ack_o),
     
@@ -652,6 +649,21 @@ module zbc (
     .sw_   	  ({GamePort_In_,GPIO_In_,MCU_In_})	// GPIO inputs
   );
 
+  // --------------------------------------------------------------------
+  // Super Simple Timer controller, shares slave 5 with the GPIO, the
+  // microsecond counter is at io 0xf104 - 0xf107
+  // --------------------------------------------------------------------
+  timer #(.res(33), .phase (12507), .us_num(2), .us_den(25))  timer0 (
+    .wb_clk_i (clk),
+    .wb_rst_i (rst),
+    .wb_adr_i (gpio_adr_i[1]),
+    .wb_dat_o (tmr_dat_o),
+    .wb_stb_i (gpio_stb_i & gpio_adr_i[2]),
+    .wb_cyc_i (gpio_cyc_i),
+    .wb_ack_o (tmr_ack_o),
+    .wb_tgc_o (intv[0])
+  );
+
   // --------------------------------------------------------------------
   // 80186 compatible CPU Instantiation
   // --------------------------------------------------------------------
@@ -728,8 +740,8 @@ module zbc (
     .s4_addr_1 (20'b1_0000_0000_0001_0000_000), // io 0x100 - 0x101
     .s4_mask_1 (20'b1_0000_1111_1111_1111_111), // SD Card IO
     
-    .s5_addr_1 (20'b1_0000_1111_0001_0000_000), // io 0xf100 - 0xf103
-    .s5_mask_1 (20'b1_0000_1111_1111_1111_110), // GPIO
+    .s5_addr_1 (20'b1_0000_1111_0001_0000_000), // io 0xf100 - 0xf107
+    .s5_mask_1 (20'b1_0000_1111_1111_1111_100), // GPIO and Timer
     
     .s6_addr_1 (20'b1_0000_1111_0010_0000_000), // io 0xf200 - 0xf20f
     .s6_mask_1 (20'b1_0000_1111_1111_1111_000), // CSR Bridge
@@ -804,14 +816,14 @@ module zbc (
     .s4_stb_o (sd_stb_i_s),
     .s4_ack_i (sd_ack_o_s),
 
-    .s5_dat_i (gpio_dat_o),			// Slave 5 interface - gpio
+    .s5_dat_i (io5_dat_o),			// Slave 5 interface - gpio, timer
     .s5_dat_o (gpio_dat_i),
     .s5_adr_o ({gpio_tga_i,gpio_adr_i}),
     .s5_sel_o (gpio_sel_i),
     .s5_we_o  (gpio_we_i),
     .s5_cyc_o (gpio_cyc_i),
     .s5_stb_o (gpio_stb_i),
-    .s5_ack_i (gpio_ack_o),
+    .s5_ack_i (io5_ack_o),
 
     .s6_dat_i (csrbrg_dat_r_s),			// Slave 6 interface - csr bridge
     .s6_dat_o (csrbrg_dat_w_s),
@@ -3,7 +3,9 @@
  * Simple Internet Control Message Protocol Implementation
  *
  * This package implements a very simple version of the ICMP (RFC 792).
- * This simply responds to a "ping".
+ * This simply responds to a "ping", from the receive loop through
+ * ip_Receive, no more than ICMP_MAXECHO of them every 100 ms so that a ping
+ * flood can't take all of the wire, and sends one of its own.
  *
  * ------------------------------------------------------------------------- */
 #include <string.h>
@@ -14,71 +16,91 @@
 static  Word   nMsg;
 extern	IP_Address		            local_IP_address;
 extern	struct Ethernet_Address	    local_ethernet_address;
-extern	struct Ethernet_Address     their_ethernet_address;
 extern	struct Ethernet_Address	    broadcast_ethernet_address;
 
-/* ----- icmp respond ------------------------------------------------------ */
-/* call this function to see if the packet just received was an icmp packet  */
-/* respond to basic echo "ping requests only, ignore others                  */
+Longword        icmp_echoes;            /* pings answered                    */
+static Longword icmp_window;            /* start of this 100 ms              */
+static int      icmp_count;             /* pings answered in it              */
+static IP_Address icmp_replied;         /* who answered our ping             */
+
+/* ----- icmp handler ------------------------------------------------------ */
+/* called by ip_Receive with an icmp datagram for us. An echo request gets   */
+/* the same thing sent back with the type changed, and the checksum with it. */
+/* an echo reply is noted for icmp_send.                                     */
 /* ------------------------------------------------------------------------- */
-int icmp_check(struct icmp_packet *rp)         /* received packet */
+void icmp_Handler(struct in_Header *ip)
 {
-	struct icmp_packet *op;                   /* output packet */
-    Byte    *ima          = (Byte *)rp - 8;   /* incoming mac address */
-	Longword rcv_IP       = rev_longword(rp->ip.destination);
-    Byte     rcv_protocol = rev_word(rp->ip.ttlProtocol)&0xFF;
-    Word     rcv_type     = rev_word(rp->icmp.type);
-
-	if((rcv_IP        == local_IP_address) &&   /* for my addr ? */
-       (rcv_protocol  == Protocol_ICMP)    &&   /* icmp ? */
-       (rcv_type      == ICMP_t_echoreq))       /* echo request ? */
-	   return(0);  			                    /* or we ignore it. */
-
-    /* we are good to go */
-	op = (struct icmp_packet *)sed_FormatPacket(ima, rev_word(Protocol_IP));
+	struct in_Header    oip;
+	struct icmp_Header *ic, oic;
+	struct sed_Frag     frag[3];
+	Longword now;
+	int hlen, len;
+
+	hlen = IP_HBYTES(ip);
+	len  = rev_word(ip->length) - hlen;
+	ic   = (struct icmp_Header *)((Byte *)ip + hlen);
+	if(len < sizeof(struct icmp_Header)) return;
+	if(checksum((Word *)ic, len) != 0xFFFF) return;
+
+	if((ic->type == ICMP_t_echoreply) && (ic->ID == 0x11)) {
+		icmp_replied = rev_longword(ip->source);
+		return;
+	}
+	if((ic->type != ICMP_t_echoreq) || (rev_longword(ip->destination) != local_IP_address)) return;
+
+	now = MsecClock();
+	if(now - icmp_window >= 100) {
+		icmp_window = now;
+		icmp_count  = 0;
+	}
+	if(++icmp_count > ICMP_MAXECHO) return;		/* too many, let it go */
+	icmp_echoes++;
 
 	/* make internet header */
-	op->ip.vht             = rev_word(0x4500);      /* version 4, hdrlen 5, tos 0 */
-    op->ip.length          = rev_word(sizeof(struct icmp_packet));
-	op->ip.identification  = rev_word(nMsg++);      /* incrementing value */
-	op->ip.frag            = 0;
-	op->ip.ttlProtocol     = rev_word((128 << 8) + Protocol_ICMP);
-	op->ip.source          = rp->ip.destination;
-	op->ip.destination     = rp->ip.source;
-    op->ip.checksum        = 0;
-	op->ip.checksum        = rev_word(~checksum((Word *)&op->ip, sizeof(struct in_Header)));
-	op->icmp.type          = ICMP_t_echoreply;
-    op->icmp.code          = ICMP_c_echoreply;
-    op->icmp.ID            = rp->icmp.ID;
-    op->icmp.Sequence      = rp->icmp.Sequence;
-    op->icmp.checksum      = 0;
-	op->icmp.checksum      = rev_word(~checksum((Word *)&op->icmp, sizeof(struct icmp_Header)));
-
-    sed_Send(sizeof(struct icmp_packet));
-    return(1);
+	oip.vht             = rev_word(IPVERTOS);      /* version 4, hdrlen 5, tos 0 */
+    oip.length          = rev_word(sizeof(struct in_Header) + len);
+	oip.identification  = rev_word(nMsg++);      /* incrementing value */
+	oip.frag            = 0;
+	oip.ttlProtocol     = rev_word((128 << 8) + Protocol_ICMP);
+	oip.source          = ip->destination;
+	oip.destination     = ip->source;
+    oip.checksum        = 0;
+	oip.checksum        = rev_word(~checksum((Word *)&oip, sizeof(struct in_Header)));
+
+	/* the same icmp header but for the type, his data goes back from where it is */
+	oic          = *ic;
+	oic.type     = ICMP_t_echoreply;
+	oic.code     = ICMP_c_echoreply;
+	oic.checksum = cksum_adjust(ic->checksum, *(Word *)ic, *(Word *)&oic);
+
+    frag[0].data = (Byte *)&oip;
+    frag[0].len  = sizeof(struct in_Header);
+    frag[1].data = (Byte *)&oic;
+    frag[1].len  = sizeof(struct icmp_Header);
+    frag[2].data = (Byte *)(ic + 1);
+    frag[2].len  = len - sizeof(struct icmp_Header);
+    sed_SendV((Byte *)&((struct eth_Header *)ip - 1)->source, rev_word(Protocol_IP), frag, 3);
 }
 
 /* ----- icmp respond ------------------------------------------------------ */
 /* call this function to send a ping icmp packet to the IP address specified */
 /* and passed as a parameter. Once sent, we wait timeout period of time and  */
 /* return 1 if the reply was received, or 0 if it was not received within    */
-/* specified period of time.
+/* specified period of time. Everything else that comes in meanwhile goes   */
+/* through the receive loop as usual.                                        */
 /* ------------------------------------------------------------------------- */
 int icmp_send(IP_Address dst, Longword timeout)
 {
-	struct icmp_packet *op, *rp;          /* output packet & received packet */
-	IP_Address rcv_IP;
+	struct icmp_packet  opk, *op = &opk;  /* output packet */
+	struct sed_Frag     frag;
+	Byte    *rp;                          /* received packet */
 	Longword expiretime;
-    int ret;
-
-	op = (struct icmp_packet *)sed_FormatPacket((Byte *)&their_ethernet_address, rev_word(Protocol_IP));
 
 	/* make icmp header */
 	op->ip.vht             = rev_word(IPVERTOS);      /* version 4, hdrlen 5, tos 0 */
     op->ip.length          = rev_word(sizeof(struct icmp_packet));
 	op->ip.identification  = rev_word(nMsg++);      /* incrementing value */
 	op->ip.frag            = 0;
-//	op->ip.ttlProtocol     = IP_TTLPROT(128, Protocol_ICMP);
 	op->ip.ttlProtocol     = rev_word((128 << 8) + Protocol_ICMP);
 	op->ip.source          = rev_longword(local_IP_address);
 	op->ip.destination     = rev_longword(dst);
@@ -91,29 +113,22 @@ int icmp_send(IP_Address dst, Longword timeout)
     op->icmp.checksum      = 0;
 	op->icmp.checksum      = rev_word(~checksum((Word *)&op->icmp, sizeof(struct icmp_Header)));
 
-    sed_Send(sizeof(struct icmp_packet)); /* send the ping out there */
+    frag.data = (Byte *)op;
+    frag.len  = sizeof(struct icmp_packet);
+    icmp_replied = 0;
+    arp_SendV(dst, rev_word(Protocol_IP), &frag, 1); /* send the ping out there */
 
-    ret = 0;
     expiretime = MsecClock()  + timeout;
     do {
-		rp = (struct icmp_packet *)sed_IsPacket();
+		rp = sed_IsPacket();
 		if(rp) {
-		   	if(sed_CheckPacket(Protocol_IP)) {   /* IP messages ? */
-                if((IP_PROTOCOL(&rp->ip) == Protocol_ICMP) &&
-                   (op->ip.source        == rp->ip.destination) &&
-                   (rp->ip.source        == op->ip.destination) &&
-                   (ICMP_t_echoreply     == rev_word(rp->icmp.type)) &&
-                   (ICMP_c_echoreply     == rev_word(rp->icmp.code)) &&
-                   (rp->icmp.ID          == 0x11) &&
-                   (rp->icmp.Sequence    == 0))
-                {
-                    ret = 1;
-                    break;
-                }
-            }
+		   	if(sed_CheckPacket(Protocol_ARP))     arp_checkpacket((struct arp_Header *)rp);	/* his mac? */
+		   	else if(sed_CheckPacket(Protocol_IP)) ip_Receive((struct in_Header *)rp);
+            if(icmp_replied == dst) return(1);
         }
+        arp_Tick();                             /* ask again for his mac */
     } while(MsecClock() < expiretime);
-    return(ret);
+    return(0);
 }
 
 /* ---- end of tinyicmp.c -------------------------------------------------- */
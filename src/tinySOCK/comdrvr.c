@@ -1,29 +1,47 @@
 /* ------------------------------------------------------------------------- */
-/* RS232 COM Driver - Super simple RS232 driver                              */
+/* RS232 COM Driver - Super simple RS232 driver, and the SLIP link on it     */
+/*                                                                           */
+/* OpenCOM, CloseCOM, WriteCOM and ReadCOM move raw bytes, one backend each  */
+/* for Win32, a POSIX termios tty (Linux) and the 8250 style port on DOS,    */
+/* which is the ZBC's WB_Serial. ReadCOM never waits. SlipPutFrame and       */
+/* SlipGetFrame sit on top of them and are the same everywhere, they take    */
+/* and hand back Ethernet frames so sed.c does not have to know.             */
 /* ------------------------------------------------------------------------- */
 #include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
 #include <windows.h>
+#elif defined(__MSDOS__)
+#include <dos.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 #pragma hdrstop
 #include "comdrvr.h"
 
 #define DEBUG_COMM_RX   0
 #define DEBUG_COMM_TX   0
 
+#if COMMDRIVER
+#if defined(_WIN32)
 /* ------------------------------------------------------------------------- */
-static HANDLE COMFile1;
+static HANDLE COMFile1 = INVALID_HANDLE_VALUE;
 static DWORD  result;
 
-#if COMMDRIVER
 /* ------------------------------------------------------------------------- */
-void OpenCOM(void)
+int OpenCOM(char *port, long baud)
 {
     DCB DCBvar;
     COMMTIMEOUTS varCommTimeouts;
-    COMFile1 = INVALID_HANDLE_VALUE;
 
-    COMFile1 = CreateFile(ConfigStr1, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    COMFile1 = CreateFile(port, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
     if(COMFile1 == INVALID_HANDLE_VALUE) {
-        printf("Cannot open port %s\n",ConfigStr1);
+        printf("Cannot open port %s\n",port);
+        return(0);
     }
     if(!SetupComm(COMFile1, RxBufferSize, TxBufferSize)) {
         printf("Unable to set the COM buffer sizes");
@@ -31,21 +49,29 @@ void OpenCOM(void)
     if(!GetCommState(COMFile1, &DCBvar)) {
         printf("Unable to GetCommState");
     }
-    DCBvar.BaudRate = 115200;
+    DCBvar.BaudRate = (DWORD)baud;
+    DCBvar.fBinary  = TRUE;
     DCBvar.fDtrControl  = DTR_CONTROL_DISABLE;
     DCBvar.fRtsControl  = RTS_CONTROL_DISABLE;
+    DCBvar.fOutxCtsFlow = FALSE;
+    DCBvar.fOutX    = FALSE;
+    DCBvar.fInX     = FALSE;
     DCBvar.ByteSize = 8;
     DCBvar.Parity   = NOPARITY;
-    DCBvar.StopBits = 0;
+    DCBvar.StopBits = ONESTOPBIT;
     if(!SetCommState(COMFile1, &DCBvar)) {
         printf("Unable to SetCommState");
+        CloseCOM();
+        return(0);
     }
-    varCommTimeouts.ReadIntervalTimeout         = 0;
+    /* reads give back what is already in, at once */
+    varCommTimeouts.ReadIntervalTimeout         = MAXDWORD;
     varCommTimeouts.ReadTotalTimeoutMultiplier  = 0;
-    varCommTimeouts.ReadTotalTimeoutConstant    = 100;
+    varCommTimeouts.ReadTotalTimeoutConstant    = 0;
     varCommTimeouts.WriteTotalTimeoutMultiplier = 0;
     varCommTimeouts.WriteTotalTimeoutConstant   = 0;
     SetCommTimeouts(COMFile1, &varCommTimeouts);
+    return(1);
 }
 //---------------------------------------------------------------------------
 void CloseCOM(void)
@@ -58,39 +84,312 @@ void CloseCOM(void)
 //---------------------------------------------------------------------------
 int  WriteCOM(unsigned char *p, int len)
 {
-    #if DEBUG_COMM_TX
-    	int i;
-	    printf("Dumping Frame content:\n");
-        for(i=0; i<len; i++) printf("%02x ",p[i]);
-        printf("\n");
-    //  return(1);
-    #endif
     if(COMFile1 == INVALID_HANDLE_VALUE) return(-1);
-    return(WriteFile(COMFile1, p, len, &result, NULL));
+    if(!WriteFile(COMFile1, p, len, &result, NULL)) return(-1);
+    return((int)result);
 }
 
 //---------------------------------------------------------------------------
 int  ReadCOM(unsigned char *p, int len)
 {
-#if DEBUG_COMM_RX
-   	int i;
-#endif
-	int ret;
-	unsigned short num;
+	DWORD num;
 
 	if(COMFile1 == INVALID_HANDLE_VALUE) return(0);
-	ret = ReadFile(COMFile1, p, len, (LPDWORD)&num, NULL);
-	if(num > 0) {
-		#if DEBUG_COMM_RX
-			printf("Dumping received content:\n");
-			for(i=0; i<num; i++) printf("%02x ",p[i]);
-			printf("\n");
-		#endif
-		return(ret);
+	if(!ReadFile(COMFile1, p, len, &num, NULL)) return(0);
+	return((int)num);
+}
+
+#elif defined(__MSDOS__)
+/* ----- 8250 on DOS ------------------------------------------------------- */
+/* Bytes come in on the receive interrupt into com_ring. Above 115200 the    */
+/* divisor is 1 and MCR bits 6:5 multiply the baud clock by 2, 4 or 8, which */
+/* is a WB_Serial extra, a PC 8250 ignores them. The receive interrupt has   */
+/* to empty the port within a character time, 22 us at 460800, so leave the  */
+/* other interrupts short when going that fast.                              */
+/* ------------------------------------------------------------------------- */
+#define COM_BASE    0x3F8           // COM1
+#define COM_VECT    0x0C            // IRQ4
+#define COM_RBR     (COM_BASE+0)    // receive / transmit
+#define COM_IER     (COM_BASE+1)
+#define COM_IIR     (COM_BASE+2)
+#define COM_LCR     (COM_BASE+3)
+#define COM_MCR     (COM_BASE+4)
+#define COM_LSR     (COM_BASE+5)
+#define COM_RING    RxBufferSize    // power of 2
+
+static unsigned char com_ring[COM_RING];
+static volatile unsigned com_head;	/* next byte in goes here, the ISR   */
+static volatile unsigned com_tail;	/* next byte out, ReadCOM            */
+static volatile unsigned com_lost;	/* the ring was full                 */
+static void interrupt (*com_oldvect)();
+static int com_open;
+
+static void interrupt com_Isr(void)
+{
+	unsigned next;
+
+	while(inportb(COM_LSR) & 0x01) {	/* data ready */
+		next = (com_head + 1) & (COM_RING - 1);
+		if(next == com_tail) {
+			inportb(COM_RBR);
+			com_lost++;
+		}
+		else {
+			com_ring[com_head] = inportb(COM_RBR);
+			com_head = next;
+		}
 	}
-	else return(0);
 }
 
+int OpenCOM(char *port, long baud)
+{
+	unsigned div, mul;
+
+	if(baud > 115200L) {
+		div = 1;
+		for(mul = 0; (mul < 3) && ((115200L << mul) < baud); mul++);
+	}
+	else {
+		div = (unsigned)(115200L / baud);
+		mul = 0;
+	}
+	com_head = com_tail = 0;
+	outportb(COM_IER, 0x00);			/* quiet while it is set up */
+	outportb(COM_LCR, 0x80);			/* DLAB */
+	outportb(COM_RBR, div & 0xFF);
+	outportb(COM_IER, div >> 8);
+	outportb(COM_LCR, 0x03);			/* 8N1 */
+	outportb(COM_MCR, 0x0B | (mul << 5));	/* DTR, RTS, OUT2, baud x 2^mul */
+	while(inportb(COM_LSR) & 0x01) inportb(COM_RBR);	/* flush */
+	com_oldvect = getvect(COM_VECT);
+	setvect(COM_VECT, com_Isr);
+	outportb(COM_IER, 0x01);			/* receive data interrupt */
+	com_open = 1;
+	return(1);
+}
+
+void CloseCOM(void)
+{
+	if(!com_open) return;
+	outportb(COM_IER, 0x00);
+	setvect(COM_VECT, com_oldvect);
+	com_open = 0;
+}
+
+int WriteCOM(unsigned char *p, int len)
+{
+	int i;
+
+	for(i = 0; i < len; i++) {
+		while(!(inportb(COM_LSR) & 0x40));	/* transmitter empty */
+		outportb(COM_RBR, *p++);
+	}
+	return(len);
+}
+
+int ReadCOM(unsigned char *p, int len)
+{
+	int n;
+
+	for(n = 0; (n < len) && (com_tail != com_head); n++) {
+		*p++ = com_ring[com_tail];
+		com_tail = (com_tail + 1) & (COM_RING - 1);
+	}
+	return(n);
+}
+
+#else
+/* ----- POSIX termios ----------------------------------------------------- */
+/* Raw 8N1 with no flow control, non-blocking, so reads give back what is   */
+/* there. The baud has to be one termios knows.                             */
+/* ------------------------------------------------------------------------- */
+static int com_fd = -1;
+
+static const struct { long baud; speed_t speed; } com_speeds[] = {
+	{   9600L, B9600   }, {  19200L, B19200  }, {  38400L, B38400  },
+	{  57600L, B57600  }, { 115200L, B115200 }, { 230400L, B230400 },
+#ifdef B460800
+	{ 460800L, B460800 },
 #endif
+#ifdef B921600
+	{ 921600L, B921600 },
+#endif
+	{ 0L, B0 }
+};
+
+int OpenCOM(char *port, long baud)
+{
+	struct termios t;
+	int i;
+
+	for(i = 0; com_speeds[i].baud && (com_speeds[i].baud != baud); i++);
+	if(com_speeds[i].baud == 0) {
+		printf("%s: no such baud as %ld\n", port, baud);
+		return(0);
+	}
+	if((com_fd = open(port, O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+		printf("Cannot open port %s\n", port);
+		return(0);
+	}
+	if(tcgetattr(com_fd, &t) == 0) {	/* not a tty, a pipe say, is fine */
+		cfmakeraw(&t);
+		t.c_cflag |= CLOCAL | CREAD;
+		t.c_cflag &= ~(CSTOPB | CRTSCTS);
+		t.c_cc[VMIN]  = 0;
+		t.c_cc[VTIME] = 0;
+		cfsetispeed(&t, com_speeds[i].speed);
+		cfsetospeed(&t, com_speeds[i].speed);
+		if(tcsetattr(com_fd, TCSANOW, &t) < 0) printf("Unable to set up %s\n", port);
+		tcflush(com_fd, TCIOFLUSH);
+	}
+	return(1);
+}
+
+void CloseCOM(void)
+{
+	if(com_fd >= 0) close(com_fd);
+	com_fd = -1;
+}
+
+int WriteCOM(unsigned char *p, int len)
+{
+	struct pollfd pf;
+	int n, done;
+
+	if(com_fd < 0) return(-1);
+	for(done = 0; done < len; done += n) {
+		n = write(com_fd, p + done, len - done);
+		if(n >= 0) continue;
+		if((errno != EAGAIN) && (errno != EINTR)) return(-1);
+		pf.fd = com_fd;					/* the tty is full, wait for room */
+		pf.events = POLLOUT;
+		poll(&pf, 1, 100);
+		n = 0;
+	}
+	return(len);
+}
+
+int ReadCOM(unsigned char *p, int len)
+{
+	int n;
+
+	if(com_fd < 0) return(0);
+	n = read(com_fd, p, len);
+	return((n > 0) ? n : 0);
+}
+#endif
+
+/* ----- SLIP link --------------------------------------------------------- */
+unsigned long slip_rxframes;
+unsigned long slip_txframes;
+unsigned long slip_errors;
+
+static const unsigned char slip_peermac[6] = SLIP_PEERMAC;
+static unsigned char slip_tx[2 * SLIP_MTU + 2];	/* worst case, all escaped */
+static unsigned char slip_rx[14 + SLIP_MTU];	/* room for the made up header */
+static unsigned char slip_arp[42];		/* the answer to our ARP request */
+static int           slip_arpready;		/* slip_arp is waiting to go up  */
+static unsigned char slip_in[256];		/* bytes read, not yet decoded   */
+static int           slip_inpos, slip_inlen;
+static int           slip_len;			/* datagram bytes in slip_rx     */
+static int           slip_esc;			/* last byte was ESC             */
+static int           slip_bad;			/* drop up to the next END       */
+
+/* ----- send a frame ------------------------------------------------------ */
+/* An IP datagram goes out SLIP framed, trimmed to its IP length so the      */
+/* Ethernet padding stays behind, in one write. An ARP request is answered   */
+/* here with the peer's made up address, anything else has nowhere to go.    */
+/* ------------------------------------------------------------------------- */
+int SlipPutFrame(unsigned char *frame, int len)
+{
+	unsigned char *p, *d;
+	int n;
+
+	if((len >= 42) && (frame[12] == 0x08) && (frame[13] == 0x06)) {
+		if((frame[20] != 0x00) || (frame[21] != 0x01)) return(1);	/* not a request */
+		memcpy(slip_arp, frame + 6, 6);			/* to whoever asked */
+		memcpy(slip_arp + 6, slip_peermac, 6);
+		memcpy(slip_arp + 12, frame + 12, 8);	/* type, hw/prot types and lengths */
+		slip_arp[20] = 0x00;
+		slip_arp[21] = 0x02;					/* reply */
+		memcpy(slip_arp + 22, slip_peermac, 6);	/* has the address asked for */
+		memcpy(slip_arp + 28, frame + 38, 4);
+		memcpy(slip_arp + 32, frame + 22, 10);	/* back to the asker */
+		slip_arpready = 1;
+		return(1);
+	}
+	if((len < 34) || (frame[12] != 0x08) || (frame[13] != 0x00)) return(0);
+
+	n = (frame[16] << 8) | frame[17];			/* IP total length */
+	if(n > len - 14) n = len - 14;
+	if(n > SLIP_MTU) return(0);
+	d = slip_tx;
+	*d++ = SLIP_END;					/* flushes any line noise at the peer */
+	for(p = frame + 14; n > 0; n--, p++) {
+		if(*p == SLIP_END)      { *d++ = SLIP_ESC; *d++ = SLIP_ESC_END; }
+		else if(*p == SLIP_ESC) { *d++ = SLIP_ESC; *d++ = SLIP_ESC_ESC; }
+		else *d++ = *p;
+	}
+	*d++ = SLIP_END;
+	#if DEBUG_COMM_TX
+		printf("SLIP sent %d bytes\n", (int)(d - slip_tx));
+	#endif
+	slip_txframes++;
+	return(WriteCOM(slip_tx, (int)(d - slip_tx)) > 0);
+}
+
+/* ----- take a frame in --------------------------------------------------- */
+/* Decodes whatever the line has given us so far, keeping a part frame for  */
+/* the next call. Returns a whole datagram with an Ethernet header to mac    */
+/* in front of it, or 0. The frame is only good until the next call.        */
 /* ------------------------------------------------------------------------- */
+unsigned char *SlipGetFrame(int *len, unsigned char *mac)
+{
+	unsigned char c;
 
+	if(slip_arpready) {
+		slip_arpready = 0;
+		*len = sizeof(slip_arp);
+		return(slip_arp);
+	}
+	for(;;) {
+		if(slip_inpos == slip_inlen) {
+			slip_inpos = 0;
+			slip_inlen = ReadCOM(slip_in, sizeof(slip_in));
+			if(slip_inlen == 0) return(0);
+		}
+		c = slip_in[slip_inpos++];
+		if(c == SLIP_END) {
+			if(slip_len && !slip_bad) break;	/* a whole one */
+			slip_len = slip_esc = slip_bad = 0;	/* empty, or thrown away */
+			continue;
+		}
+		if(slip_bad) continue;
+		if(slip_esc) {
+			slip_esc = 0;
+			if(c == SLIP_ESC_END)      c = SLIP_END;
+			else if(c == SLIP_ESC_ESC) c = SLIP_ESC;
+			else { slip_bad = 1; slip_errors++; continue; }
+		}
+		else if(c == SLIP_ESC) {
+			slip_esc = 1;
+			continue;
+		}
+		if(slip_len == SLIP_MTU) { slip_bad = 1; slip_errors++; continue; }
+		slip_rx[14 + slip_len++] = c;
+	}
+	#if DEBUG_COMM_RX
+		printf("SLIP received %d bytes\n", slip_len);
+	#endif
+	memcpy(slip_rx, mac, 6);
+	memcpy(slip_rx + 6, slip_peermac, 6);
+	slip_rx[12] = 0x08;							/* IP */
+	slip_rx[13] = 0x00;
+	*len = 14 + slip_len;
+	slip_len = 0;
+	slip_rxframes++;
+	return(slip_rx);
+}
+
+#endif
+/* ------------------------------------------------------------------------- */
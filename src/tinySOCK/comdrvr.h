@@ -1,26 +1,56 @@
 //---------------------------------------------------------------------------
-// RS232 COM Driver
+// RS232 COM Driver and SLIP link
 //---------------------------------------------------------------------------
 #ifndef COMDRIVER1H
 #define COMDRIVER1H
 
 /* ----- Control Definitions ----------------------------------------------- */
-/* If COMMDRIVER is set to 1, then the rs232 to ethernet nic is being used   */
-/* otherwise it will compile assuming the ZBC NIC interface                  */
+/* If COMMDRIVER is set to 1, then the stack runs over a serial line with    */
+/* SLIP framing instead of the ZBC NIC, to a peer such as Linux slattach     */
 /* ------------------------------------------------------------------------- */
-#define COMMDRIVER 	0  /* set this to 1 to use the RS232 NIC                 */
+#ifndef COMMDRIVER
+#define COMMDRIVER 	0  /* set this to 1 to use the serial SLIP link          */
+#endif
 
 //---------------------------------------------------------------------------
+#if defined(_WIN32)
 #define  ConfigStr1     "COM1:"     // For sending data
+#elif defined(__MSDOS__)
+#define  ConfigStr1     "COM1"      // 0x3F8 and IRQ4, the ZBC WB_Serial port
+#else
+#define  ConfigStr1     "/dev/ttyS0"
+#endif
+#define  ConfigBaud     115200L     // up to 921600, see OpenCOM
 #define  RxBufferSize   4096        //
 #define  TxBufferSize   4096        //
 
+/* ----- SLIP -------------------------------------------------------------- */
+/* RFC 1055, each IP datagram goes END, the bytes with END and ESC escaped,  */
+/* END. The link has no link level addresses, the driver makes up an        */
+/* Ethernet header for what comes in and answers our own ARP requests with  */
+/* SLIP_PEERMAC, so the stack above works as it does on the NIC.            */
+/* The peer's MTU wants to match, "ifconfig sl0 mtu 1500" on Linux.         */
+/* ------------------------------------------------------------------------- */
+#define  SLIP_END       0xC0        // end of a frame
+#define  SLIP_ESC       0xDB        // next byte is escaped
+#define  SLIP_ESC_END   0xDC        // ESC ESC_END is a data 0xC0
+#define  SLIP_ESC_ESC   0xDD        // ESC ESC_ESC is a data 0xDB
+#define  SLIP_MTU       1500        // biggest IP datagram either way
+#define  SLIP_PEERMAC   {0x02,0x53,0x4C,0x49,0x50,0x00}  // "SLIP", made up
+
 #if COMMDRIVER
 /* ------------------------------------------------------------------------- */
-void OpenCOM(void);
+int  OpenCOM(char *port, long baud);	/* 1 = open, 0 = failed */
 void CloseCOM(void);
-int  WriteCOM(unsigned char *p, int len);
-int  ReadCOM( unsigned char *p, int len);
+int  WriteCOM(unsigned char *p, int len);	/* waits until it is all out */
+int  ReadCOM( unsigned char *p, int len);	/* what is there, 0 if nothing */
+
+int  SlipPutFrame(unsigned char *frame, int len);
+unsigned char *SlipGetFrame(int *len, unsigned char *mac);
+
+extern unsigned long slip_rxframes;	/* datagrams taken in                */
+extern unsigned long slip_txframes;	/* datagrams sent                    */
+extern unsigned long slip_errors;	/* too long, bad escape, or overrun  */
 #endif
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+#!/bin/sh
+# ----- gzroot.sh - precompress a TinyHTTP web root -----------------------------
+#
+# Run this on the host over the web root before it goes on the ZBC disk. Each
+# file gets a gzip'ed sibling that TinyHTTP sends to browsers that take gzip.
+# For DOS the siblings go in a mirror of the web root under GZ, with the same
+# names, the same as http_GzName() in tinyhttp.c (INDEX.HTM -> GZ/INDEX.HTM,
+# JS/A.JS -> GZ/JS/A.JS), or use -u for a server that isn't on DOS, where it
+# is the name with .gz on. Files that are already compressed, or that don't
+# get any smaller, are left alone and the plain file is sent. Two files that
+# would get the same sibling on DOS, which doesn't see case, stop it with an
+# error rather than one of them being served for the other.
+#
+# usage: gzroot.sh [-u] webroot
+# -------------------------------------------------------------------------------
+
+unix=0
+if [ "$1" = "-u" ]; then unix=1; shift; fi
+if [ $# -ne 1 ] || [ ! -d "$1" ]; then
+	echo "usage: gzroot.sh [-u] webroot" >&2
+	exit 1
+fi
+
+# ----- name of the compressed sibling, see http_GzName() -----------------------
+root="${1%/}"
+gzname()
+{
+	if [ $unix = 1 ]; then echo "$1.gz"; return; fi
+	echo "$root/GZ/${1#$root/}"
+}
+
+seen=$(mktemp) || exit 1
+trap 'rm -f "$seen"' EXIT
+find "$root" -type f | while read -r f; do
+	case "$(echo "$f" | tr 'A-Z' 'a-z')" in
+	*.gz|*.z|*.zip|*.gif|*.jpg|*.jpeg|*.png|*.img) continue ;;
+	"$(echo "$root" | tr 'A-Z' 'a-z')"/gz/*) continue ;;	# ours, from last time
+	esac
+	gz=$(gzname "$f")
+	key=$gz
+	[ $unix = 1 ] || key=$(echo "$gz" | tr 'a-z' 'A-Z')
+	if grep -qxF "$key" "$seen"; then
+		echo "gzroot.sh: $f has the same sibling as another file, $gz" >&2
+		exit 1
+	fi
+	echo "$key" >> "$seen"
+	mkdir -p "$(dirname "$gz")" || exit 1
+	gzip -9 -n -c "$f" > "$gz.tmp" || exit 1
+	plain=$(wc -c < "$f")
+	small=$(wc -c < "$gz.tmp")
+	if [ "$small" -lt "$plain" ]; then
+		mv "$gz.tmp" "$gz"
+		echo "$f  $plain -> $small  $gz"
+	else
+		rm -f "$gz.tmp" "$gz"
+		echo "$f  $plain, left plain"
+	fi
+done
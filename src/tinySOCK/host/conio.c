@@ -0,0 +1,75 @@
+/* ----- conio.c - console keys for the host build ---------------------------
+ *
+ * The demos look at the keyboard with kbhit and getch while the stack runs.
+ * On a terminal the keys are taken a character at a time without an echo,
+ * and the terminal is put back when we exit. When stdin is a file or pipe
+ * the characters in it are the keys, and once it is used up no more come,
+ * so a server can be run from a script and stopped with a signal.
+ *
+ * ------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include "conio.h"
+
+static int            con_setup;		/* stdin looked at */
+static int            con_eof;			/* nothing more will come */
+static struct termios con_saved;
+
+/* ----- put the terminal back --------------------------------------------- */
+static void con_restore(void)
+{
+	tcsetattr(0, TCSANOW, &con_saved);
+}
+
+/* ----- a key at a time, no echo ------------------------------------------ */
+static void con_init(void)
+{
+	struct termios t;
+
+	con_setup = 1;
+	if(!isatty(0) || tcgetattr(0, &con_saved) < 0) return;
+	t = con_saved;
+	t.c_lflag &= ~(ICANON | ECHO);
+	t.c_cc[VMIN]  = 1;
+	t.c_cc[VTIME] = 0;
+	tcsetattr(0, TCSANOW, &t);
+	atexit(con_restore);
+}
+
+/* ----- is a key waiting -------------------------------------------------- */
+int kbhit(void)
+{
+	struct pollfd p;
+
+	if(!con_setup) con_init();
+	if(con_eof) return 0;
+	p.fd     = 0;
+	p.events = POLLIN;
+	return poll(&p, 1, 0) > 0;
+}
+
+/* ----- take a key -------------------------------------------------------- */
+int getch(void)
+{
+	unsigned char c;
+
+	if(!con_setup) con_init();
+	if(con_eof || read(0, &c, 1) != 1) {
+		con_eof = 1;
+		return -1;
+	}
+	return c;
+}
+
+/* ----- write a character ------------------------------------------------- */
+int putch(int c)
+{
+	putchar(c);
+	fflush(stdout);
+	return c;
+}
+
+/* ----- end of conio.c ---------------------------------------------------- */
@@ -0,0 +1,13 @@
+/* ----- conio.h - host build stand in for the Borland console calls ------ */
+/* kbhit doesn't wait and says if a key is there, getch takes it without an  */
+/* echo and putch writes one out. See conio.c.                               */
+/* ------------------------------------------------------------------------- */
+#ifndef HOST_CONIO_H
+#define HOST_CONIO_H
+
+int kbhit(void);
+int getch(void);
+int putch(int c);
+
+#endif
+/* ----- end of conio.h ---------------------------------------------------- */
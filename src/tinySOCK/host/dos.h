@@ -0,0 +1,4 @@
+/* ----- dos.h - host build stand in -------------------------------------- */
+/* Nothing the stack uses comes from here, the port and interrupt calls are  */
+/* all in sed.c, which the host build replaces with sedhost.c.               */
+/* ------------------------------------------------------------------------- */
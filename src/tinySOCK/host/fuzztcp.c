@@ -0,0 +1,193 @@
+/* ----- fuzztcp.c - feeds made up segments to the TCP input ------------------
+ *
+ * Each input is a conversation with a listener on port 80, HOST_ADDR:1234 to
+ * MY_ADDR:80. It is split into segments, each with a two byte length ahead
+ * of it (big end first), and every one goes in through ip_Receive() with an
+ * ethernet and IP header put on and the ports and TCP checksum put right, so
+ * they get past the checks and into the state machine. What the listener
+ * gets it writes back, so the output side gets a go as well. Nothing goes on
+ * the wire, sed_Init() isn't called.
+ *
+ * With FUZZ_LIBFUZZER it is the libFuzzer entry point, build it with
+ * clang -fsanitize=fuzzer. Without, it is a program that does the inputs in
+ * the files it is given, or that many made up ones:
+ *
+ *   fuzztcp [-n count] [file ...]
+ *
+ * ------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tinysock.h"
+
+#define FUZZ_MYPORT		80
+#define FUZZ_HISPORT	1234
+#define FUZZ_HDRS		(sizeof(struct eth_Header) + sizeof(struct in_Header))
+
+IP_Address local_IP_address;
+
+int LLVMFuzzerTestOneInput(const Byte *data, size_t size);
+
+static struct tcp_Socket fuzz_s;
+
+/* ----- what comes in goes back ------------------------------------------- */
+static void fuzz_Handler(struct tcp_Socket *s, Byte *dp, int len)
+{
+	if((dp != 0) && (len > 0)) tcp_Write(s, dp, len);
+}
+
+/* ----- one segment, in a frame of its own -------------------------------- */
+/* The frame is just big enough, so the sanitizers see a read off the end.  */
+/* ------------------------------------------------------------------------- */
+static void fuzz_Segment(const Byte *seg, int len)
+{
+	struct eth_Header *eh;
+	struct in_Header  *ip;
+	struct tcp_Header *tp;
+	struct tcp_Pseudoheader ph;
+	Byte    *frame;
+	Longword lw;
+
+	if(len > IP_MAXLEN - sizeof(struct in_Header)) len = IP_MAXLEN - sizeof(struct in_Header);
+	if((frame = malloc(FUZZ_HDRS + len)) == 0) return;
+	eh = (struct eth_Header *)frame;
+	ip = (struct in_Header *)(eh + 1);
+	tp = (struct tcp_Header *)(ip + 1);
+
+	memset(eh, 0, sizeof(*eh));
+	eh->source.MAC[0]  = 0x02;
+	eh->source.MAC[5]  = 0x02;
+	eh->type           = rev_word(Protocol_IP);
+	memset(ip, 0, sizeof(*ip));
+	ip->vht            = rev_word(IPVERTOS);
+	ip->length         = rev_word(sizeof(struct in_Header) + len);
+	ip->ttlProtocol    = rev_word((64 << 8) | Protocol_TCP);
+	ip->source         = rev_longword(HOST_ADDR);
+	ip->destination    = rev_longword(MY_ADDR);
+	ip->checksum       = ~(Word)nchecksum((Word *)ip, sizeof(struct in_Header));
+	memcpy(tp, seg, len);
+
+	if(len >= sizeof(struct tcp_Header)) {		/* short ones go as they are */
+		tp->srcPort  = rev_word(FUZZ_HISPORT);
+		tp->dstPort  = rev_word(FUZZ_MYPORT);
+		tp->checksum = 0;
+		ph.src       = ip->source;
+		ph.dst       = ip->destination;
+		ph.mbz       = 0;
+		ph.protocol  = Protocol_TCP;
+		ph.length    = rev_word(len);
+		lw  = nchecksum((Word *)&ph, sizeof(ph) - 2);
+		lw += nchecksum((Word *)tp, len);
+		while(lw & 0xFFFF0000L) lw = (lw & 0xFFFFL) + (lw >> 16);
+		tp->checksum = ~(Word)lw;
+	}
+	ip_Receive(ip);
+	free(frame);
+}
+
+/* ----- one input, a conversation ----------------------------------------- */
+int LLVMFuzzerTestOneInput(const Byte *data, size_t size)
+{
+	static int once;
+	int len;
+
+	if(!once) {
+		once = 1;
+		freopen("/dev/null", "w", stdout);		/* the stack talks a lot */
+	}
+	tcp_Init();
+	local_IP_address = MY_ADDR;
+	tcp_Listen(&fuzz_s, FUZZ_MYPORT, (Procref)fuzz_Handler, 0L);
+
+	while(size >= 2) {
+		len = (data[0] << 8) | data[1];
+		data += 2, size -= 2;
+		if(len > size) len = size;
+		fuzz_Segment(data, len);
+		data += len, size -= len;
+	}
+	if(fuzz_s.state != 0 && fuzz_s.state != TS_CLOSED) tcp_Abort(&fuzz_s);
+	return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+/* ----- made up inputs ---------------------------------------------------- */
+/* A SYN, then ACKs and data with the sequence numbers near enough, then   */
+/* some bits turned over, so they get a fair way in before going wrong.    */
+/* ------------------------------------------------------------------------- */
+static Longword fuzz_seed = 1;
+
+static Longword fuzz_Rand(void)
+{
+	fuzz_seed = fuzz_seed * 1103515245L + 12345;
+	return (fuzz_seed >> 8) & 0xFFFFFF;
+}
+
+static int fuzz_Make(Byte *buf, int max)
+{
+	struct tcp_Header tcp;
+	Longword seq = fuzz_Rand() << 8;
+	Longword ack = 1;						/* our iss is 0 */
+	int i, n, len, segs = 1 + fuzz_Rand() % 8, at = 0;
+	Word flags;
+
+	for(i = 0; i < segs; i++) {
+		len = (fuzz_Rand() % 4) ? 0 : fuzz_Rand() % 600;
+		if(fuzz_Rand() % 8 == 0) len += (fuzz_Rand() % 4) * 4;	/* options */
+		n   = sizeof(tcp) + len;
+		if(at + 2 + n > max) break;
+		flags = (i == 0) ? TCPF_SYN : TCPF_ACK;
+		if(fuzz_Rand() % 6 == 0) flags |= 1 << (fuzz_Rand() % 6);
+		memset(&tcp, 0, sizeof(tcp));
+		tcp.seqnum = rev_longword(seq);
+		tcp.acknum = rev_longword(fuzz_Rand() % 3 ? ack : fuzz_Rand());
+		tcp.flags  = rev_word(flags | (5 + (fuzz_Rand() % 4 ? 0 : fuzz_Rand() % 11)) << 12);
+		tcp.window = rev_word((Word)fuzz_Rand());
+		buf[at++]  = n >> 8;
+		buf[at++]  = n;
+		memcpy(buf + at, &tcp, sizeof(tcp));
+		for(n = 0; n < len; n++) buf[at + sizeof(tcp) + n] = (Byte)fuzz_Rand();
+		at  += sizeof(tcp) + len;
+		seq += len + (i == 0);
+		ack += (i == 0) ? 0 : len;			/* what he echoes, near enough */
+	}
+	for(n = fuzz_Rand() % 4; n > 0 && at; n--) buf[fuzz_Rand() % at] ^= 1 << (fuzz_Rand() % 8);
+	return at;
+}
+
+/* ----- main -------------------------------------------------------------- */
+int main(int argc, char *argv[])
+{
+	static Byte buf[16384];
+	long  i, count = 100000L;
+	int   n, files = 0;
+	FILE *f;
+
+	for(i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			count = atol(argv[++i]);
+			continue;
+		}
+		if((f = fopen(argv[i], "rb")) == 0) {
+			perror(argv[i]);
+			return 1;
+		}
+		n = fread(buf, 1, sizeof(buf), f);
+		fclose(f);
+		LLVMFuzzerTestOneInput(buf, n);
+		files++;
+	}
+	if(files) {
+		fprintf(stderr, "fuzztcp: %d inputs ok\n", files);
+		return 0;
+	}
+	for(i = 0; i < count; i++) {
+		n = fuzz_Make(buf, sizeof(buf));
+		LLVMFuzzerTestOneInput(buf, n);
+	}
+	fprintf(stderr, "fuzztcp: %ld made up inputs ok\n", count);
+	return 0;
+}
+#endif
+
+/* ----- end of fuzztcp.c -------------------------------------------------- */
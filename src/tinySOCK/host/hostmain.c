@@ -0,0 +1,420 @@
+/* ----- hostmain.c - TinySOCK on a Linux host --------------------------------
+ *
+ * The stack as it is, on top of sedhost.c, for measuring it. The servers are
+ * MY_ADDR and the clients HOST_ADDR from options.h, run a server and then a
+ * client and they find each other on the default UDP link.
+ *
+ * usage: tinysock [-v] mode [args]
+ *   http            TinyHTTP serving the current directory, q stops it
+ *   sink            throws away what comes in on port 5001, says how fast
+ *   get FILE [N]    GET /FILE from the http server N times
+ *   bulk [MB]       send MB megabytes to the sink
+ *   ping [N]        N pings to the server
+ *   bench [KB]      all of the above, with its own http server and sink at
+ *                   the other end of a socketpair: ping, GETs of 1 KB, KB
+ *                   and 1 MB files, and a bulk send, then some of it
+ *                   again with 1% and with 5% of the frames lost
+ *
+ * With TINYSOCK_SLIP set (see sedhost.c) the same clients measure a serial
+ * line, to a server on another machine or a Linux slattach peer.
+ *
+ * The stack talks a lot on stdout, the clients send that to /dev/null
+ * unless there is a -v and only the results are printed.
+ *
+ * ------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "tinysock.h"
+#include "sedhost.h"
+#include "conio.h"
+
+#define SINK_PORT	5001
+#define HOST_WAIT	10.0e6		/* us a GET or bulk send is given */
+
+IP_Address local_IP_address;	/* the servers are MY_ADDR, the clients HOST_ADDR */
+
+static FILE    *out;			/* where the results go */
+static jmp_buf  host_done;
+static int    (*host_step) P(( void ));
+static Word     host_port = 20000;	/* next local port */
+
+/* ----- microseconds ------------------------------------------------------ */
+static double host_usec(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1.0e6 + t.tv_nsec / 1.0e3;
+}
+
+/* ----- run tcp() until step says it is done ------------------------------ */
+static void host_application(void)
+{
+	if((*host_step)()) longjmp(host_done, 1);
+}
+
+static void host_run(int (*step) P(( void )))
+{
+	host_step = step;
+	if(setjmp(host_done) == 0) tcp(host_application);
+}
+
+/* ----- next local port --------------------------------------------------- */
+static Word host_nextport(void)
+{
+	if(++host_port < 20000) host_port = 20000;
+	return host_port;
+}
+
+/* ----- client side of the link ------------------------------------------- */
+static void host_client(void)
+{
+	sed_Init();
+	sed_CapStart();
+	tcp_Init();
+	local_IP_address = HOST_ADDR;
+}
+
+/* ----- ping -------------------------------------------------------------- */
+static void host_ping(int n)
+{
+	double t, rtt, min = 0, max = 0, sum = 0;
+	int    i, got = 0;
+
+	for(i = 0; i < n; i++) {
+		if(i) usleep(1000000L / ICMP_MAXECHO / 5);	/* under his rate limit */
+		t = host_usec();
+		if(!icmp_send(MY_ADDR, 1000L)) continue;
+		rtt = host_usec() - t;
+		if(got == 0 || rtt < min) min = rtt;
+		if(rtt > max) max = rtt;
+		sum += rtt;
+		got++;
+	}
+	fprintf(out, "ping      %4d sent %4d back  rtt min %.0f avg %.0f max %.0f us\n",
+			n, got, min, got ? sum / got : 0.0, max);
+}
+
+/* ----- GET --------------------------------------------------------------- */
+#define GET_OPEN	0
+#define GET_WAIT	1			/* for the connection */
+#define GET_READ	2			/* until he closes it */
+#define GET_DONE	3
+#define GET_FAILED	4
+
+static struct tcp_Socket get_s;
+static char   get_req[160];
+static int    get_state, get_n, get_count, get_fail;
+static long   get_bytes;
+static double get_t0, get_min, get_max, get_sum, get_all;
+
+static void get_Handler(struct tcp_Socket *s, Byte *dp, int len)
+{
+	if(dp == 0) get_state = (len < 0) ? GET_FAILED : GET_DONE;
+	else get_bytes += len;
+}
+
+static int get_Step(void)
+{
+	double us;
+
+	switch(get_state) {
+	case GET_OPEN:
+		get_bytes = 0;
+		get_t0    = host_usec();
+		get_state = GET_WAIT;
+		tcp_Open(&get_s, host_nextport(), MY_ADDR, 80, (Procref)get_Handler);
+		break;
+	case GET_WAIT:
+		if(get_s.state == TS_ESTAB) {
+			tcp_Write(&get_s, (Byte *)get_req, strlen(get_req));
+			get_state = GET_READ;
+		}
+		break;
+	case GET_DONE:
+	case GET_FAILED:
+		us = host_usec() - get_t0;
+		if((get_state == GET_FAILED) || (get_bytes == 0)) get_fail++;
+		else {
+			if(get_sum == 0 || us < get_min) get_min = us;
+			if(us > get_max) get_max = us;
+			get_sum += us;
+			get_all += get_bytes;
+		}
+		if(++get_count == get_n) return True;
+		get_state = GET_OPEN;
+		return False;
+	}
+	if(host_usec() - get_t0 > HOST_WAIT) tcp_Abort(&get_s);	/* handler says failed */
+	return False;
+}
+
+static void host_get(char *file, int n)
+{
+	int ok;
+	Longword frames;
+
+	frames = sed_txframes + sed_rxframes;
+	sprintf(get_req, "GET /%.100s HTTP/1.1\r\nHost: tinysock\r\nConnection: close\r\n\r\n", file);
+	get_state = GET_OPEN;
+	get_n     = n;
+	get_count = get_fail = 0;
+	get_min   = get_max = get_sum = get_all = 0;
+	host_run(get_Step);
+
+	ok = n - get_fail;
+	frames = sed_txframes + sed_rxframes - frames;
+	fprintf(out, "get %-10s %4d ok %4d failed  ms min %.2f avg %.2f max %.2f  %.0f KB/s  %.1f frames\n",
+			file, ok, get_fail, get_min / 1000, ok ? get_sum / ok / 1000 : 0.0, get_max / 1000,
+			get_sum ? get_all / 1024 / (get_sum / 1.0e6) : 0.0, (double)frames / n);
+}
+
+/* ----- bulk send to the sink --------------------------------------------- */
+static struct tcp_Socket bulk_s;
+static Byte   bulk_buf[TCP_MAXSEG];
+static long   bulk_left, bulk_size;
+static int    bulk_failed;
+static double bulk_t0;
+
+static void bulk_Handler(struct tcp_Socket *s, Byte *dp, int len)
+{
+	if((dp == 0) && (len < 0)) bulk_failed = True;
+}
+
+static int bulk_Step(void)
+{
+	int n;
+
+	if(bulk_failed) return True;
+	if(host_usec() - bulk_t0 > HOST_WAIT + bulk_size / 10) {	/* 10 MB/s is a bit slow */
+		tcp_Abort(&bulk_s);
+		return True;
+	}
+	if(bulk_s.state != TS_ESTAB) {		/* FIN acked, it's all there */
+		return (bulk_left == 0) && ((bulk_s.state == TS_AFIN) || (bulk_s.state == TS_TIMEWT) ||
+									(bulk_s.state == TS_CLOSED));
+	}
+	while(bulk_left > 0) {
+		n = bulk_left < sizeof(bulk_buf) ? (int)bulk_left : sizeof(bulk_buf);
+		if((n = tcp_Write(&bulk_s, bulk_buf, n)) == 0) break;
+		bulk_left -= n;
+	}
+	if(bulk_left == 0) tcp_Close(&bulk_s);
+	return False;
+}
+
+static void host_bulk(int mb)
+{
+	double us;
+
+	memset(bulk_buf, 'x', sizeof(bulk_buf));
+	bulk_size   = bulk_left = (long)mb << 20;
+	bulk_failed = False;
+	bulk_t0     = host_usec();
+	tcp_Open(&bulk_s, host_nextport(), MY_ADDR, SINK_PORT, (Procref)bulk_Handler);
+	host_run(bulk_Step);
+
+	us = host_usec() - bulk_t0;
+	if(bulk_failed || (bulk_s.state == TS_CLOSED && bulk_left)) fprintf(out, "bulk      failed, %ld bytes left\n", bulk_left);
+	else fprintf(out, "bulk      %4d MB in %.0f ms  %.2f MB/s\n", mb, us / 1000, mb / (us / 1.0e6));
+}
+
+/* ----- sink server ------------------------------------------------------- */
+static struct tcp_Socket sink_s;
+static long   sink_bytes;
+static Longword sink_start;
+
+static void sink_Handler(struct tcp_Socket *s, Byte *dp, int len)
+{
+	Longword ms;
+
+	if(dp == 0) {						/* he's done, and listen again */
+		ms = MsecClock() - sink_start;
+		if(ms == 0) ms = 1;
+		printf("sink: %ld bytes in %lu ms, %ld KB/s\n", sink_bytes, (unsigned long)ms,
+			   sink_bytes / (long)ms);
+		sink_bytes = 0;
+		tcp_Listen(&sink_s, SINK_PORT, (Procref)sink_Handler, 0L);
+		return;
+	}
+	if((sink_bytes == 0) && (len > 0)) sink_start = MsecClock();
+	sink_bytes += len;
+}
+
+static void sink_application(void)
+{
+	if(kbhit() && getch() == 'q') exit(0);
+}
+
+static void host_sink(void)
+{
+	sed_Init();
+	sed_CapStart();
+	tcp_Init();
+	local_IP_address = MY_ADDR;
+	tcp_Listen(&sink_s, SINK_PORT, (Procref)sink_Handler, 0L);
+	printf("sink on port %d, q to stop\n", SINK_PORT);
+	tcp(sink_application);
+}
+
+/* ----- server in a child at the other end of a socketpair ---------------- */
+static pid_t bench_server(void (*server) P(( void )))
+{
+	int   sv[2];
+	pid_t pid;
+
+	if(socketpair(AF_UNIX, SOCK_DGRAM, 0, sv) < 0) {
+		perror("socketpair");
+		exit(1);
+	}
+	fflush(NULL);
+	if((pid = fork()) == 0) {
+		close(sv[0]);
+		freopen("/dev/null", "r", stdin);
+		freopen("/dev/null", "w", stdout);
+		unsetenv("TINYSOCK_CAPTURE");	/* the client side has it */
+		sed_hostfd = sv[1];
+		sed_hostid = 1;
+		server();
+		exit(0);
+	}
+	close(sv[1]);
+	sed_Deinit();						/* from the last one */
+	sed_hostfd = sv[0];
+	sed_hostid = 2;
+	host_client();
+	return pid;
+}
+
+static void bench_stop(pid_t pid)
+{
+	kill(pid, SIGTERM);
+	waitpid(pid, 0, 0);
+	close(sed_hostfd);
+}
+
+/* ----- a file of so many KB ---------------------------------------------- */
+static void bench_file(char *name, long kb)
+{
+	FILE *f = fopen(name, "wb");
+	long  i;
+
+	for(i = 0; i < kb * 1024; i++) putc(i & 0xFF, f);
+	fclose(f);
+}
+
+static void host_bench(int kb)
+{
+	char  dir[] = "/tmp/tinysockXXXXXX";
+	char  mid[32];
+	pid_t pid;
+
+	if(mkdtemp(dir) == 0 || chdir(dir) < 0) {
+		perror(dir);
+		exit(1);
+	}
+	sprintf(mid, "%dk.bin", kb);
+	bench_file("1k.bin", 1);
+	bench_file(mid, kb);
+	bench_file("1m.bin", 1024);
+
+	pid = bench_server(http);
+	host_ping(100);
+	host_get("1k.bin", 200);
+	host_get(mid, 50);
+	host_get("1m.bin", 5);
+	bench_stop(pid);
+
+	pid = bench_server(host_sink);
+	host_bulk(8);
+	bench_stop(pid);
+
+	setenv("TINYSOCK_LOSS", "1", 1);	/* both ends, the server forks after */
+	fprintf(out, "1%% of the frames lost\n");
+	pid = bench_server(http);
+	host_get(mid, 20);
+	host_get("1m.bin", 2);
+	bench_stop(pid);
+	pid = bench_server(host_sink);
+	host_bulk(8);
+	bench_stop(pid);
+
+	setenv("TINYSOCK_LOSS", "5", 1);
+	fprintf(out, "5%% of the frames lost\n");
+	pid = bench_server(http);
+	host_get("1k.bin", 50);
+	host_get(mid, 10);
+	bench_stop(pid);
+	pid = bench_server(host_sink);
+	host_bulk(1);
+	bench_stop(pid);
+	unsetenv("TINYSOCK_LOSS");
+
+	unlink("1k.bin");
+	unlink(mid);
+	unlink("1m.bin");
+	if(chdir("/") == 0) rmdir(dir);
+}
+
+/* ----- usage ------------------------------------------------------------- */
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: tinysock [-v] mode [args]\n"
+		"  http            serve the current directory\n"
+		"  sink            discard on port %d\n"
+		"  get FILE [N]    GET /FILE N times\n"
+		"  bulk [MB]       send MB megabytes to the sink\n"
+		"  ping [N]        ping the server N times\n"
+		"  bench [KB]      all of it, against its own servers\n", SINK_PORT);
+	exit(1);
+}
+
+/* ----- main -------------------------------------------------------------- */
+int main(int argc, char *argv[])
+{
+	int verbose = 0;
+	char *mode;
+
+	if(argc > 1 && strcmp(argv[1], "-v") == 0) {
+		verbose = 1;
+		argc--, argv++;
+	}
+	if(argc < 2) usage();
+	mode = argv[1];
+
+	if(strcmp(mode, "http") == 0 || strcmp(mode, "sink") == 0) {
+		if(!getenv("TINYSOCK_LINK")) setenv("TINYSOCK_LINK", "7001:127.0.0.1:7002", 0);
+		if(mode[0] == 'h') http();
+		else host_sink();
+		return 0;
+	}
+
+	/* a client, keep the results apart from the chatter */
+	fflush(stdout);
+	out = fdopen(dup(1), "w");
+	setvbuf(out, 0, _IOLBF, 0);
+	if(!verbose) freopen("/dev/null", "w", stdout);
+
+	if(strcmp(mode, "bench") == 0) {
+		host_bench(argc > 2 ? atoi(argv[2]) : 64);
+		return 0;
+	}
+	if(!getenv("TINYSOCK_LINK")) setenv("TINYSOCK_LINK", "7002:127.0.0.1:7001", 0);
+	host_client();
+	if(strcmp(mode, "ping") == 0) host_ping(argc > 2 ? atoi(argv[2]) : 10);
+	else if(strcmp(mode, "get") == 0 && argc > 2) host_get(argv[2], argc > 3 ? atoi(argv[3]) : 10);
+	else if(strcmp(mode, "bulk") == 0) host_bulk(argc > 2 ? atoi(argv[2]) : 8);
+	else usage();
+	return 0;
+}
+
+/* ----- end of hostmain.c ------------------------------------------------- */
@@ -0,0 +1,8 @@
+/* ----- io.h - host build stand in for the Borland low level file calls -- */
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <unistd.h>		/* read, lseek, close */
+
+#endif
+/* ----- end of io.h ------------------------------------------------------- */
@@ -0,0 +1,401 @@
+/* --- host Ethernet driver --------------------------------------------------
+ *
+ * The sed primitives for running TinySOCK as a Linux process, so the stack
+ * above them can be run, measured and fuzzed without a ZBC. Frames go over
+ * a datagram socket, one datagram to a frame, header and payload with no
+ * preamble or FCS, to a peer process that is another TinySOCK or anything
+ * else that can speak Ethernet in UDP.
+ *
+ * TINYSOCK_LINK=lport:host:pport   the UDP link, we are on lport and the
+ *                                  peer is at host:pport
+ * TINYSOCK_SLIP=tty[:baud]         the SLIP link of comdrvr.c instead, IP
+ *                                  only, to slattach or a ZBC at the other
+ *                                  end of the serial line, 115200 baud if
+ *                                  none is given
+ * TINYSOCK_REPLAY=file.pcap        frames come in from a capture instead
+ *                                  (Ethernet, as fast as they are asked for),
+ *                                  what we send still goes down the link
+ * TINYSOCK_LOSS=n                  throw away n percent of the frames that
+ *                                  come in, to watch the retransmits work
+ * TINYSOCK_CAPTURE=file.pcap       every frame sent and taken in goes to it,
+ *                                  from sed_CapStart() on, there is no ring
+ *                                  here and sed_CapSave() just flushes it
+ *
+ * A program can instead set sed_hostfd to a datagram socket before sed_Init,
+ * one end of a socketpair say, and then there is no UDP link at all.
+ *
+ * Which frames are taken in is decided by ../SEDFILT.C, the same code the
+ * ZBC driver uses.
+ *
+ * ------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#undef  IP_TOS						/* the socket options, ours are macros */
+#undef  IP_TTL
+#include "tinysock.h"
+#include "sed.h"
+#include "sedhost.h"
+#include "comdrvr.h"
+
+#define SED_LINK	"7001:127.0.0.1:7002"
+
+/* ----- globals referenced in arp ----------------------------------------- */
+struct Ethernet_Address	local_ethernet_address;     /* local ethernet address */
+struct Ethernet_Address	broadcast_ethernet_address; /* Ethernet broadcast address */
+struct Ethernet_Address their_ethernet_address;     /* the other guys' mac   */
+
+int      sed_hostfd = -1;
+Byte     sed_hostid;
+Longword sed_rxframes;
+Longword sed_txframes;
+Longword sed_lost;
+Longword sed_rxskip;
+
+static int   sed_fd = -1;		/* where frames go, -1 = nowhere */
+static int   sed_connected;		/* sed_fd has a peer, no address needed */
+static int   sed_slip;			/* frames go over the SLIP link */
+static struct sockaddr_in sed_peer;
+static FILE *sed_replay;		/* capture being played back */
+static int   sed_swapped;		/* capture is the other byte order */
+static int   sed_loss;			/* percent to lose */
+static FILE *sed_cap;			/* capture being written */
+static Longword sed_capframes;	/* frames in it */
+static Byte  sed_tx[SED_MAXFRAME];
+static Byte  sed_rx[SED_MAXFRAME];
+	struct eth_Header *rcv = (struct eth_Header *)sed_rx;
+
+/* ----- pcap headers ------------------------------------------------------ */
+struct pcap_File {
+	Longword	magic;
+	Word		major, minor;
+	Longword	zone, sigfigs, snaplen, linktype;
+};
+struct pcap_Rec {
+	Longword	sec, usec, incl, orig;
+};
+
+/* ----- capture byte order ------------------------------------------------ */
+static Longword pcap_long(Longword l)
+{
+	return sed_swapped ? rev_longword(l) : l;
+}
+
+/* ----- open the capture -------------------------------------------------- */
+static void sed_OpenReplay(char *name)
+{
+	struct pcap_File h;
+
+	if((sed_replay = fopen(name, "rb")) == 0) {
+		perror(name);
+		exit(1);
+	}
+	if(fread(&h, sizeof(h), 1, sed_replay) != 1) h.magic = 0;
+	if((h.magic == 0xD4C3B2A1U) || (h.magic == 0x4D3CB2A1U)) sed_swapped = 1;
+	h.magic    = pcap_long(h.magic);
+	h.linktype = pcap_long(h.linktype);
+	if(((h.magic != 0xA1B2C3D4U) && (h.magic != 0xA1B23C4DU)) || (h.linktype != 1)) {
+		fprintf(stderr, "%s: not an Ethernet pcap file\n", name);
+		exit(1);
+	}
+}
+
+/* ----- next frame from the capture --------------------------------------- */
+static int sed_ReadReplay(void)
+{
+	struct pcap_Rec r;
+	Longword len;
+
+	if(fread(&r, sizeof(r), 1, sed_replay) != 1) goto done;
+	len = pcap_long(r.incl);
+	if(len > SED_MAXFRAME) {
+		if(fseek(sed_replay, len, SEEK_CUR) < 0) goto done;
+		return 0;
+	}
+	if(fread(sed_rx, 1, len, sed_replay) != len) goto done;
+	return len;
+done:
+	fclose(sed_replay);
+	sed_replay = 0;
+	return 0;
+}
+
+/* ----- open the UDP link ------------------------------------------------- */
+static void sed_OpenLink(char *spec)
+{
+	struct sockaddr_in me;
+	char   host[64];
+	int    lport, pport, size;
+
+	if(sscanf(spec, "%d:%63[^:]:%d", &lport, host, &pport) != 3) {
+		fprintf(stderr, "TINYSOCK_LINK=%s, want lport:host:pport\n", spec);
+		exit(1);
+	}
+	memset(&me, 0, sizeof(me));
+	me.sin_family      = AF_INET;
+	me.sin_port        = htons(lport);
+	me.sin_addr.s_addr = htonl(INADDR_ANY);
+	memset(&sed_peer, 0, sizeof(sed_peer));
+	sed_peer.sin_family = AF_INET;
+	sed_peer.sin_port   = htons(pport);
+	if(inet_pton(AF_INET, host, &sed_peer.sin_addr) != 1) {
+		fprintf(stderr, "TINYSOCK_LINK: bad address %s\n", host);
+		exit(1);
+	}
+	sed_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if((sed_fd < 0) || (bind(sed_fd, (struct sockaddr *)&me, sizeof(me)) < 0)) {
+		perror("TINYSOCK_LINK");
+		exit(1);
+	}
+	size = 1 << 20;				/* room for a window or two of frames */
+	setsockopt(sed_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+	if(sed_hostid == 0) sed_hostid = (Byte)lport;
+}
+
+/* ----- open the SLIP link ------------------------------------------------ */
+static void sed_OpenSlip(char *spec)
+{
+	char  port[256];
+	long  baud = ConfigBaud;
+
+	if(sscanf(spec, "%255[^:]:%ld", port, &baud) < 1) {
+		fprintf(stderr, "TINYSOCK_SLIP=%s, want tty[:baud]\n", spec);
+		exit(1);
+	}
+	if(!OpenCOM(port, baud)) exit(1);
+	sed_slip = 1;
+}
+
+/* ----- Initialization ---------------------------------------------------- */
+int sed_Init(void)
+{
+	char *s;
+	int   i;
+
+	if(sed_hostfd >= 0) {
+		sed_fd = sed_hostfd;
+		sed_connected = 1;
+	}
+	else if((s = getenv("TINYSOCK_SLIP")) != 0) {
+		if(!sed_slip) sed_OpenSlip(s);
+	}
+	else if(sed_fd < 0) {
+		s = getenv("TINYSOCK_LINK");
+		sed_OpenLink(s ? s : SED_LINK);
+	}
+	if((s = getenv("TINYSOCK_REPLAY")) != 0) sed_OpenReplay(s);
+	sed_loss = ((s = getenv("TINYSOCK_LOSS")) != 0) ? atoi(s) : 0;
+
+	/* locally administered, the last byte tells the processes apart */
+	local_ethernet_address.MAC[0] = 0x02; local_ethernet_address.MAC[1] = 0x00;
+	local_ethernet_address.MAC[2] = 0x00; local_ethernet_address.MAC[3] = 0x00;
+	local_ethernet_address.MAC[4] = 0x00; local_ethernet_address.MAC[5] = sed_hostid;
+	for(i = 0; i < 6; i++) broadcast_ethernet_address.MAC[i] = 0xFF;
+	return(1);
+}
+
+/* ----- capture ---------------------------------------------------------- */
+void sed_CapStart(void)
+{
+	struct pcap_File h;
+	char *name;
+
+	if(sed_cap || (name = getenv("TINYSOCK_CAPTURE")) == 0) return;
+	if((sed_cap = fopen(name, "wb")) == 0) {
+		perror(name);
+		return;
+	}
+	memset(&h, 0, sizeof(h));
+	h.magic    = 0xA1B2C3D4U;
+	h.major    = 2;
+	h.minor    = 4;
+	h.snaplen  = SED_MAXFRAME;
+	h.linktype = 1;
+	fwrite(&h, sizeof(h), 1, sed_cap);
+	sed_capframes = 0;
+}
+
+void sed_CapStop(void)
+{
+	if(sed_cap) fclose(sed_cap);
+	sed_cap = 0;
+}
+
+int sed_CapSave(char *name)
+{
+	if(sed_cap) fflush(sed_cap);
+	return((int)sed_capframes);
+}
+
+static void sed_CapFrame(Byte *frame, int len)
+{
+	struct pcap_Rec r;
+	struct timespec t;
+
+	clock_gettime(CLOCK_REALTIME, &t);
+	r.sec  = t.tv_sec;
+	r.usec = t.tv_nsec / 1000;
+	r.incl = r.orig = len;
+	fwrite(&r, sizeof(r), 1, sed_cap);
+	fwrite(frame, len, 1, sed_cap);
+	sed_capframes++;
+}
+
+/* ----- deinit the interface ---------------------------------------------- */
+int sed_Deinit(void)
+{
+	if((sed_fd >= 0) && !sed_connected) close(sed_fd);
+	sed_fd = -1;
+	if(sed_slip) CloseCOM();
+	sed_slip = 0;
+	if(sed_replay) fclose(sed_replay);
+	sed_replay = 0;				/* a capture goes on, to the end */
+	return(1);
+}
+
+/* ----- put a frame on the wire ------------------------------------------- */
+static int sed_Put(Byte *frame, int len)
+{
+	if(len < E10P_MIN) {
+		memset(frame + len, 0, E10P_MIN - len);
+		len = E10P_MIN;
+	}
+	if(sed_cap) sed_CapFrame(frame, len);
+	if(sed_slip) {
+		sed_txframes++;
+		return(SlipPutFrame(frame, len));
+	}
+	if(sed_fd < 0) return(1);			/* nowhere to send it, the fuzzer */
+	sed_txframes++;
+	if(sed_connected) send(sed_fd, frame, len, 0);
+	else sendto(sed_fd, frame, len, 0, (struct sockaddr *)&sed_peer, sizeof(sed_peer));
+	return(1);
+}
+
+/* ----- format the Ethernet Frame ----------------------------------------- */
+/* no preamble here, the frame starts at the front of the buffer             */
+/* ------------------------------------------------------------------------- */
+Byte *sed_FormatPacket(Byte *destEAddr, Word ethType)
+{
+	Move(destEAddr, sed_tx, 6);
+	Move((Byte *)&local_ethernet_address, sed_tx + 6, 6);
+	Move(&ethType, sed_tx + 12, 2);
+	return(sed_tx + 14);
+}
+
+/* ----- Send Packet ------------------------------------------------------- */
+int sed_Send(int pkLengthInBytes)
+{
+	return(sed_Put(sed_tx, pkLengthInBytes + 14));
+}
+
+/* ----- Send gathered Packet ---------------------------------------------- */
+int sed_SendV(Byte *destEAddr, Word ethType, struct sed_Frag *frag, int nfrag)
+{
+	Byte *p;
+	int	  len;
+
+	p   = sed_FormatPacket(destEAddr, ethType);
+	len = 0;
+	for(; nfrag > 0; nfrag--, frag++) {
+		if(len + frag->len > SED_MAXFRAME - 14) return(0);
+		if(frag->len) Move(frag->data, p + len, frag->len);
+		len += frag->len;
+	}
+	return(sed_Send(len));
+}
+
+/* ----- Receive Packet ---------------------------------------------------- */
+Byte *sed_Receive(Word Protocol)
+{
+	Byte *p;
+
+	p = sed_IsPacket();
+	if(p && !sed_CheckPacket(Protocol)) p = 0;
+	return(p);
+}
+
+/* ----- receive room ------------------------------------------------------ */
+/* the socket buffer holds plenty, say what an empty ZBC NIC and queue would */
+/* ------------------------------------------------------------------------- */
+int sed_RxRoom(void)
+{
+	return(4 + SED_RXQ);
+}
+
+/* ----- is Packet --------------------------------------------------------- */
+/* next frame for us, from the capture while it lasts and then the link, or  */
+/* 0 at once if there is nothing                                             */
+/* ------------------------------------------------------------------------- */
+Byte *sed_IsPacket(void)
+{
+	Byte *p;
+	int len;
+
+	for(;;) {
+		if(sed_replay) len = sed_ReadReplay();
+		else if(sed_slip) {
+			p = SlipGetFrame(&len, local_ethernet_address.MAC);
+			if(p) memcpy(sed_rx, p, len);
+			else  len = -1;
+		}
+		else if(sed_fd >= 0) len = recv(sed_fd, sed_rx, sizeof(sed_rx), MSG_DONTWAIT);
+		else len = -1;
+		if(len < 0) {
+			sched_yield();				/* the other end may be on this cpu */
+			return(0);
+		}
+		if(len < 14) continue;
+		sed_rxframes++;
+		if(sed_loss && (rand() % 100 < sed_loss)) {
+			sed_lost++;
+			continue;
+		}
+		if(!sed_Peek(sed_rx, len)) {		/* sedfilt.c, as on the ZBC */
+			sed_rxskip++;
+			continue;
+		}
+		if(sed_cap) sed_CapFrame(sed_rx, len);
+		return(sed_rx + 14);
+	}
+}
+
+/* ----- Check Packet ------------------------------------------------------ */
+int sed_CheckPacket(Word expectedType)
+{
+	if(rcv->type != rev_word(expectedType)) return(0);
+	return(1);
+}
+
+/* ----- millisecond clock ------------------------------------------------- */
+/* from when we first asked, starting at 1 so it is never 0, which is what a */
+/* stopped timer looks like                                                  */
+/* ------------------------------------------------------------------------- */
+Longword MsecClock(void)
+{
+	static struct timespec t0;
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	if(t0.tv_sec == 0 && t0.tv_nsec == 0) t0 = t;
+	return (Longword)((t.tv_sec - t0.tv_sec) * 1000L + (t.tv_nsec - t0.tv_nsec) / 1000000L + 1);
+}
+
+/* ----- microsecond clock ------------------------------------------------- */
+/* wraps like the one in the FPGA timer does, after 71 minutes               */
+/* ------------------------------------------------------------------------- */
+Longword MicroClock(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (Longword)(t.tv_sec * 1000000L + t.tv_nsec / 1000L);
+}
+
+/* ---- end of sedhost.c --------------------------------------------------- */
@@ -0,0 +1,15 @@
+/* ----- sedhost.h - the host build's Ethernet driver --------------------- */
+/* Things the host programs can set or look at besides the sed_ calls.       */
+/* ------------------------------------------------------------------------- */
+#ifndef SEDHOST_H
+#define SEDHOST_H
+
+extern int      sed_hostfd;		/* datagram socket to use, -1 opens the UDP link */
+extern Byte     sed_hostid;		/* last byte of our MAC, 0 = from the link port  */
+extern Longword sed_rxframes;	/* frames taken in                               */
+extern Longword sed_txframes;	/* frames sent                                   */
+extern Longword sed_lost;		/* frames thrown away by TINYSOCK_LOSS           */
+extern Longword sed_rxskip;		/* frames not for us, or sed_Filter didn't want  */
+
+#endif
+/* ----- end of sedhost.h -------------------------------------------------- */
@@ -2,22 +2,36 @@
 /* PROTO.H - function prototypes for TinySOCK 	                             */
 /* ------------------------------------------------------------------------- */
 
-/* ----- in arp.c  --------------------------------------------------------- */
+/* ----- in tinyarp.c  ----------------------------------------------------- */
 int arp_checkpacket P(( struct arp_Header *ap ));
 int sar_MapIn2Eth   P(( Longword ina, struct Ethernet_Address *ethap ));
 int do_arp(IP_Address their_IP_address);
+int arp_Lookup      P(( IP_Address ina, struct Ethernet_Address *ethap ));
+int arp_SendV       P(( IP_Address ina, Word ethType, struct sed_Frag *frag, int nfrag ));
+void arp_ipin       P(( struct in_Header *ip ));
+void arp_Tick       P(( void ));
 
 /* ----- in sed.c or sedslip.c --------------------------------------------- */
 int   sed_Init P(( void ));
 int   sed_Deinit P(( void ));
 Byte *sed_FormatPacket(Byte *destEAddr, Word ethType);
 int   sed_Send P(( int pkLengthInOctets ));
+int   sed_SendV P(( Byte *destEAddr, Word ethType, struct sed_Frag *frag, int nfrag ));
 Byte *sed_Receive P(( Word Protocol ));
 Byte *sed_IsPacket P(( void ));
+int   sed_RxRoom P(( void ));
 int   sed_CheckPacket(Word expectedType);
+int   sed_checkMAC P(( Byte *mac ));
+void  sed_Filter P(( Procpeek accept ));
+void  sed_Multicast P(( Byte *mac ));
+void  sed_CapStart P(( void ));
+void  sed_CapStop P(( void ));
+int   sed_CapSave P(( char *name ));
 
 /* ----- byte order reversal crap ------------------------------------------ */
-#ifdef BIG_ENDIAN
+/* glibc's endian.h defines both BIG_ENDIAN and LITTLE_ENDIAN as numbers,    */
+/* so it takes BIG_ENDIAN on its own to mean this machine is big endian.     */
+#if defined(BIG_ENDIAN) && !defined(LITTLE_ENDIAN)
 #define     rev_word( w )       ((w))
 #define     rev_longword( l )   ((l))
 #else
@@ -32,11 +46,16 @@ Longword    swapWords(Longword x);
 
 /* ----- in tinyudp.c ------------------------------------------------------ */
 Word UDPChecksum16(Longword v);  /* weird UDP checksum fix */
+void udp_Handler P(( struct in_Header *ip ));
+int  udp_Open P(( struct udp_Socket *s, Word lport, Procref handler ));
+void udp_Close P(( struct udp_Socket *s ));
+int  udp_SendTo P(( struct udp_Socket *s, IP_Address ina, Word port, Byte *dp, int len ));
+int  udp_RecvFrom P(( struct udp_Socket *s, IP_Address *ina, Word *port, Byte *dp, int maxlen ));
 void udp_send(IP_Address dstIP, Word portno, Byte *message, Word payloadlen);
 Word udp_receive(struct udp_packet *p, Word portno, Byte *rcv_message, Word maxlen);
 
 /* ----- in icmp.c --------------------------------------------------------- */
-int icmp_check(struct icmp_packet *rp);
+void icmp_Handler P(( struct in_Header *ip ));
 int icmp_send(IP_Address dst, Longword timeout);
 
 
@@ -47,6 +66,9 @@ void tcp_Listen P(( struct tcp_Socket *s, Word port, Procref datahandler, Longwo
 void tcp_Close  P(( struct tcp_Socket *s ));
 void tcp_Abort  P(( struct tcp_Socket *s ));
 int  tcp        P(( Procrefv application ));
+int  ip_Register P(( Byte protocol, Procip handler ));
+void ip_Receive P(( struct in_Header *ip ));
+int  ip_Accept P(( Byte *frame, int len ));
 
 int tcp_Write P(( struct tcp_Socket *s, Byte *dp, int len ));
 void tcp_Flush P(( struct tcp_Socket *s ));
@@ -54,13 +76,26 @@ void tcp_Send P(( struct tcp_Socket *s ));
 
 /* the following are internal to TCP, and hence, static                      */
 static void tcp_Unthread P(( struct tcp_Socket *ds ));
+static void tcp_Closed P(( struct tcp_Socket *s ));
 static void tcp_Retransmitter P(( void ));
 static void tcp_ProcessData P(( struct tcp_Socket *s, struct tcp_Header *tp, int len ));
 static void tcp_DumpHeader P(( struct in_Header *ip, struct tcp_Header *tp, char *mesg ));
 static void tcp_Handler P(( struct in_Header *ip ));
+static void tcp_Template P(( struct tcp_Socket *s ));
+static void tcp_Segment P(( struct tcp_Socket *s, Longword seq, Word flags, Byte *dp, int len ));
+static void tcp_Acked P(( struct tcp_Socket *s, struct tcp_Header *tp, int len ));
+static void tcp_RttUpdate P(( struct tcp_Socket *s, Longword m ));
+static void tcp_Timer P(( struct tcp_Socket *s ));
+static void tcp_FastRtx P(( struct tcp_Socket *s ));
+static int  tcp_Data P(( struct tcp_Socket *s ));
+static void tcp_Output P(( void ));
+static void tcp_Options P(( struct tcp_Socket *s, struct tcp_Header *tp ));
+static Word tcp_RcvWindow P(( struct tcp_Socket *s ));
 
 Word checksum P(( Word *dp, int length ));
 Longword lchecksum P(( Word *dp, int length ));
+Longword nchecksum P(( Word *dp, int length ));
+Word cksum_adjust P(( Word hc, Word m, Word mnew ));
 
 /* ----- in tinyftp.c ------------------------------------------------------ */
 void ftp_ctlHandler P(( struct tcp_Socket *s, Byte *dp, int len ));
@@ -70,11 +105,25 @@ void ftp_Abort P(( void ));
 void ftp_application P(( void ));
 void ftp P(( IP_Address host ));
 void ftp_server_handler P(( struct tcp_Socket *s, Byte *dp, int len ));
+void ftp_server_data P(( struct tcp_Socket *s, Byte *dp, int len ));
 void ftp_local_command P(( char *s ));
+int  tftp_Get P(( IP_Address host, char *remote, char *local ));
+int  tftp_Put P(( IP_Address host, char *local, char *remote ));
+int  tftp_Busy P(( void ));
+void tftp_Tick P(( void ));
+int  tftp_Serve P(( void ));
+void tftp_application P(( void ));
+void tftp P(( IP_Address host ));
+
+/* ----- in tinyhttp.c ----------------------------------------------------- */
+void http_connect P(( struct tcp_Socket *s, Byte *dp, int len ));
+void http P(( void ));
 
 /* ----- in anyplace ------------------------------------------------------- */
-/* sometimes we need a timer, this is a call to a ms timer                   */
+/* sometimes we need a timer, this is a call to a ms timer, and a us one     */
+/* that wraps, only ever take the difference of two MicroClock readings      */
 Longword MsecClock P((void));
+Longword MicroClock P((void));
 
 /* ----- end of proto.h ---------------------------------------------------- */
 
@@ -7,7 +7,7 @@
 #define	octet		unsigned char	/*  8 bits */
 
 /* ----- Control Definitions ----------------------------------------------- */
-/* If COMMDRIVER is set to 1, then the rs232 to ethernet nic is being used   */
+/* If COMMDRIVER is set to 1, then the serial SLIP link in comdrvr.c is used */
 /* otherwise it will compile assuming the ZBC NIC interface                  */
 /* ------------------------------------------------------------------------- */
 
@@ -17,14 +17,66 @@
 #define TXSTATUS PORTBASE     // Transmit Status  Register
 #define TXCONTRL PORTBASE+1   // Transmit Control and MSB Address Register
 #define TXADDRSS PORTBASE+2   // Transmit Buffer  LSB Address Register
-#define TXBUFFER PORTBASE+3   // Transmit Buffer  Data Register
+#define TXBUFFER PORTBASE+3   // Transmit Buffer  Data Register, auto-increment
 #define RXSTATUS PORTBASE+4	  // Receive  Status  Register
 #define RXCONTRL PORTBASE+5   // Receive  Control and MSB Address Register
 #define RXADDRSS PORTBASE+6   // Receive  Buffer  LSB Address Register
-#define RXBUFFER PORTBASE+7   // Receive  Buffer  Data Register
+#define RXBUFFER PORTBASE+7   // Receive  Buffer  Data Register, auto-increment
+#define TXBUFWRD PORTBASE+2   // Transmit Buffer  Data Register, word access
+#define RXBUFWRD PORTBASE+6   // Receive  Buffer  Data Register, word access
+
+/* ----- ZBC Timer IO Port Definitions ------------------------------------- */
+#define TIMERLOW 0xF104       // Microseconds 15:0, word read, latches 31:16
+#define TIMERHIGH 0xF106      // Microseconds 31:16, as latched by TIMERLOW
+/* ------------------------------------------------------------------------- */
+#endif
+
+/* ----- receive ring and interrupt ---------------------------------------- */
+/* The NIC holds 4 frames in its own ring, the driver queues SED_RXQ more.   */
+/* Set SED_IRQ to 0 to poll the NIC ring from sed_IsPacket instead.          */
+/* ------------------------------------------------------------------------- */
+#define SED_IRQ      1        /* 1 = take frames in on the receive interrupt */
+#define SED_IRQVECT  0x0F     /* IRQ7 is the 10BaseT Interface               */
+#ifndef SED_RXQ
+#define SED_RXQ      4        /* frames queued between the NIC and the stack */
+#endif
+#define SED_MAXFRAME 1536     /* largest frame plus FCS, rounded up          */
+
+/* ----- frame check sequence ---------------------------------------------- */
+/* With SED_HWFCS set the NIC appends the FCS on transmit and the driver     */
+/* drops received frames the NIC flags with a bad FCS. Set it to 0 for a NIC */
+/* without the FCS logic and the CRC is done in software instead.            */
+/* ------------------------------------------------------------------------- */
+#define SED_HWFCS    1        /* 1 = the NIC does the Ethernet FCS           */
+
+/* ----- receive filter ---------------------------------------------------- */
+/* With SED_HWFILT set the NIC drops frames that are not for our address,    */
+/* broadcast or a group sed_Multicast() has joined, before they take a slot. */
+/* Either way the driver reads the first SED_PEEK bytes of a frame, the     */
+/* Ethernet header and the IP header and ports or the whole of an ARP, and   */
+/* only copies the rest if the handler given to sed_Filter() takes it.      */
 /* ------------------------------------------------------------------------- */
+#define SED_HWFILT   1        /* 1 = the NIC filters on the destination      */
+#define SED_PEEK     42       /* bytes read before the frame is judged, even */
+
+extern Byte sed_mhash[8];     /* groups joined, sedfilt.c                    */
+int  sed_Peek P(( Byte *frame, int len ));
+#if !COMMDRIVER
+void sed_LoadFilter P(( void ));
 #endif
 
+/* ----- capture ----------------------------------------------------------- */
+/* With SED_CAPTURE set the driver keeps the last SED_CAPFRAMES frames sent  */
+/* and received, the first SED_CAPSNAP bytes of each (the headers and a bit) */
+/* with the MsecClock time, from sed_CapStart() on. sed_CapSave() writes     */
+/* them out as a pcap file, and they go to SED_CAPFILE on the way out.      */
+/* On the SLIP link the frames are kept with the Ethernet header it makes up.*/
+/* ------------------------------------------------------------------------- */
+#define SED_CAPTURE   0       /* 1 = build the capture ring in               */
+#define SED_CAPFRAMES 128     /* frames the ring holds                        */
+#define SED_CAPSNAP   80      /* bytes kept of each                          */
+#define SED_CAPFILE   "SED.CAP"	/* written at exit if anything was taken    */
+
 /* ----- timeouts for zbc nic ---------------------------------------------- */
 #define RX_TIMEOOUT	100
 #define TX_TIMEOOUT 100
@@ -32,6 +84,10 @@
 /* ----------------------------------------------------------------------------
  * Below are the bit assigments for the Status and Control Registers.
  * The lower 4 bits of the Control Register are the MSB bits of the Buffer.
+ * The buffer address is a pointer that moves on by one after every access
+ * to the Data Register, load it once and then stream the bytes in or out.
+ * A word access (inport/outport) at TXBUFWRD or RXBUFWRD moves two bytes,
+ * low byte first, and moves the pointer on by two.
  *
  *  |7|6|5|4|3|2|1|0|  Transmit Status Register:
  *   | | | | | | | `-- 0       - Not used, reads zero
@@ -50,31 +106,40 @@
  *   | | | | | `------ A10     - Address Bit 10 of buffer
  *   | | | | `-------- 0       - Not used, reads zero
  *   | | | `---------- 0       - Not used, reads zero
- *   | | `------------ 0       - Not used, reads zero
+ *   | | `------------ FTFCS   - Append the FCS to the frame when it is sent
  *   | `-------------- FTINT   - Enable interrupt on completion of frame transmit
- *   `---------------- FTSND   - Send contents of transmit buffer now
+ *   `---------------- FTSND   - Send contents of transmit buffer now, the pointer
+ *                               is left alone on this write, it holds the length
  *
  *
  *  |7|6|5|4|3|2|1|0|  Receive Status Register:
- *   | | | | | | | `-- 0       - Not used, reads zero
- *   | | | | | | `---- 0       - Not used, reads zero
- *   | | | | | `------ 0       - Not used, reads zero
- *   | | | | `-------- 0       - Not used, reads zero
- *   | | | `---------- 0       - Not used, reads zero
- *   | | `------------ 0       - Not used, reads zero
+ *   | | | | | | | `-- TAIL0   - NIC ring slot being read, bit 0
+ *   | | | | | | `---- TAIL1   - NIC ring slot being read, bit 1
+ *   | | | | | `------ HEAD0   - NIC ring slot being filled, bit 0
+ *   | | | | `-------- HEAD1   - NIC ring slot being filled, bit 1
+ *   | | | `---------- FRBAD   - The frame at the tail failed the FCS check
+ *   | | `------------ FROVR   - A frame was dropped because the NIC ring was full
  *   | `-------------- FRRX    - Indicates a complete Ethernet frameis being received, but no in yet
- *   `---------------- FRCVD   - Indicates a complete Ethernet frame was, 0 if no frame waiting
- *                               writting anything to this register clears bit7, FRCVD
+ *   `---------------- FRCVD   - Indicates a complete Ethernet frame is at the tail, 0 if ring empty
+ *                               writting anything to this register gives the tail slot back,
+ *                               clears FROVR and sets the buffer address to 0
  *
- *  |7|6|5|4|3|2|1|0|  Receive Control Register
+ *  |7|6|5|4|3|2|1|0|  Receive Control Register, reads back length bits 10:8 of the tail frame
  *   | | | | | | | `-- A08     - Address Bit  8 of buffer
  *   | | | | | | `---- A09     - Address Bit  9 of buffer
  *   | | | | | `------ A10     - Address Bit 10 of buffer
- *   | | | | `-------- 0       - Not used, reads zero
- *   | | | `---------- 0       - Not used, reads zero
+ *   | | | | `-------- FRSET   - Writes to the Data register load the filter table
+ *   | | | `---------- FRFLT   - Drop frames not for our address, broadcast or a hashed group
  *   | | `------------ 0       - Not used, reads zero
  *   | `-------------- FRINT   - Allow Interrupt to be generated on receipt of new frame
- *   `---------------- FRRCV   - Allow a frame to be receive into buffer, set to 0 to hold while processing
+ *   `---------------- FRRCV   - Allow frames to be received into the NIC ring
+ *
+ *  The Receive Address Register reads back length bits 7:0 of the tail frame.
+ *
+ *  The filter table is 14 bytes, loaded a byte at a time through the Data
+ *  Register with FRSET set, the pointer picks the byte. 0-5 are our address,
+ *  6-13 the multicast hash, bit n is bit n%8 of byte 6+n/8, n being bits
+ *  31:26 of the CRC register (not complemented) over the 6 destination bytes.
  *
  * ---------------------------------------------------------------------------*/
 
@@ -25,6 +25,7 @@
 #define  Protocol_ARP   0x0806      /* Address Resolution Protocol (ARP)     */
 #define  Protocol_ICMP    0x01      /* ICMP/IP protocol                      */
 #define  Protocol_UDP     0x11      /* UDP/IP protocol                       */
+#define  Protocol_TCP     0x06      /* TCP/IP protocol                       */
 
 
 /* ----- address macro ----------------------------------------------------- */
@@ -42,11 +43,28 @@
 #define P(x) x
 
 /* ----- Canonically-sized data ------------------------------------------- */
+/* Longword is 32 bits, a long on DOS and Win32 but an int on a 64 bit host. */
+/* Longint is the signed one, for sequence numbers and times that can wrap,  */
+/* (Longint)(a - b) < 0 is a before b.                                      */
+#if defined(__LP64__) || defined(_LP64)
+typedef  unsigned int   Longword;
+typedef  int            Longint;
+#else
 typedef  unsigned long  Longword;
+typedef  long           Longint;
+#endif
 typedef  unsigned short Word;
 typedef  unsigned char  Byte;
 typedef  unsigned char  BOOL;
 
+/* ----- structure layout -------------------------------------------------- */
+/* Borland lays structures out byte aligned, and the wire formats below are  */
+/* written that way, arp_Header has an address that isn't on a long. Do the  */
+/* same with gcc for the host build.                                         */
+#ifdef __GNUC__
+#pragma pack(push, 1)
+#endif
+
 /* ----- byte order reversal crap ------------------------------------------ */
 union ValWords {
     Longword lw;
@@ -75,6 +93,13 @@ struct Ethernet_Address { Byte   MAC[6]; };
 typedef void ( *Procref  ) P(( void *s, Byte *dp, int len ));
 typedef void ( *Procrefv ) P(( void ));
 
+/* ----- Transmit gather list ---------------------------------------------- */
+/* One piece of a packet handed to sed_SendV, they go out in list order.     */
+struct sed_Frag {
+	Byte	*data;				/* where the bytes are */
+	int		 len;				/* how many of them */
+};
+
 /* ----- The Ethernet header ----------------------------------------------- */
 struct eth_Header {
 	struct	Ethernet_Address destination;	/* 48 bits = 6 bytes */
@@ -109,6 +134,14 @@ struct in_Header {
 #define IP_TOS(ip)		    (  rev_word((ip)->vht)        & 0xff)
 #define IP_TTL(ip)		    (  rev_word((ip)->ttlProtocol) >> 8)
 #define IP_PROTOCOL(ip)	    (  rev_word((ip)->ttlProtocol) & 0xff)
+
+/* ----- receive side ------------------------------------------------------ */
+typedef void ( *Procip ) P(( struct in_Header *ip ));	/* protocol handler */
+typedef int  ( *Procpeek ) P(( Byte *frame, int len ));	/* frame filter, sed_Filter */
+#define IP_MAXPROTO	6		/* protocols ip_Receive hands on to              */
+#define IP_BURST	8		/* frames tcp() takes before timers and the app  */
+#define IP_MAXLEN	1500	/* biggest datagram that fits in a frame         */
+#define ICMP_MAXECHO 10		/* echo replies each 100 ms, more are dropped    */
 #define IP_TTLPROT(t,p)     (  rev_word(((t) << 8) + (p))
 
 /* ----- UDP header -------------------------------------------------------- */
@@ -125,6 +158,39 @@ struct udp_packet {
 	struct udp_Header	udp;
 };
 
+/* ------ UDP Socket definition -------------------------------------------- */
+/* In the DOS large model all static data shares the one 64 KB DGROUP, so    */
+/* the sizes marked DOS below, here and in the modules, are cut down for it. */
+/* Any of them can be set on the command line instead.                       */
+/* ------------------------------------------------------------------------- */
+#define UDP_MAXDATA	1472	/* biggest payload, 1500 byte MTU less headers   */
+#ifndef UDP_QSIZE
+#ifdef __MSDOS__
+#define UDP_QSIZE	1536	/* DOS, one datagram of UDP_MAXDATA and its head */
+#else
+#define UDP_QSIZE	2048	/* receive queue, datagrams and their udp_Queued */
+#endif
+#endif
+#define UDP_EPHEMERAL 49152u	/* first port handed out for a port of 0     */
+
+struct udp_Socket {
+	struct udp_Socket * next;	        /* pointer to next socket           */
+	Word		myport;                 /* port we are bound to             */
+	Procref		dataHandler;	        /* called with datagrams, 0 = queue */
+	IP_Address	hisaddr;		        /* who the last datagram was from   */
+	Word		hisport;                /* and his port                     */
+	short		queued;                 /* datagrams waiting in q           */
+	short		qlen;                   /* bytes used in q                  */
+	Longword	drops;                  /* datagrams lost, queue was full   */
+	Byte		q[ UDP_QSIZE ];         /* udp_Queued then data, in order   */
+};
+
+struct udp_Queued {                     /* ahead of each datagram in q      */
+	IP_Address	from;
+	Word		port;
+	Word		len;
+};
+
 /* ----- TCP header -------------------------------------------------------- */
 struct tcp_Header {
 	Word		srcPort;
@@ -178,22 +244,47 @@ rr 940529 There should not be a state 0 in here. When a socket is unlinked
 #define TS_CLOSED	11	/* (closed) finack received */
 
 /* ------ TCP Socket definition -------------------------------------------- */
-#define TCP_MAXDATA	512		/* maximum bytes to buffer on output             */
+#define TCP_MAXSEG	1460	/* largest segment, 1500 byte MTU less headers   */
+#define TCP_MSS		536		/* segment size when the peer doesn't say        */
+#define TCP_RCVMSS	1460	/* segment size we offer, see tcp_RcvWindow      */
+#ifndef TCP_MAXDATA
+#define TCP_MAXDATA	(3*TCP_MAXSEG)	/* output buffer, sent and unsent    */
+#endif
 
 struct tcp_Socket {
 	struct tcp_Socket * next;	        /* pointer to next socket           */
 	short		state;			        /* connection state                 */
 	Procref		dataHandler;	        /* called with incoming data        */
-	struct Ethernet_Address hisethaddr;	/* ethernet address of peer         */
 	IP_Address	hisaddr;		        /* internet address of peer         */
 	Word		myport, hisport;        /* tcp ports for this connection    */
 	Longword	acknum;                 /* data ack'd number                */
-    Longword	seqnum;                 /* data sequence num                */
+	Longword	snd_una;                /* oldest unacked seq, is data[0]   */
+	Longword	snd_nxt;                /* next seq to send                 */
+	Word		snd_wnd;                /* window the peer is offering      */
+	Word		mss;                    /* largest segment the peer takes   */
+	Longword	rcv_adv;                /* right edge of window we offered  */
+	Longword	snd_max;                /* highest seq sent so far          */
+	Longword	snd_rec;                /* resent up to here, no fast rtx   */
+	Longword	rtx_time;               /* retransmit timer, 0 = stopped    */
+	Longword	rtt_seq;                /* seq being timed for the rtt      */
+	Longword	rtt_start;              /* when it went, 0 = nothing timed  */
+	Word		srtt;                   /* smoothed rtt, ms x 8             */
+	Word		rttvar;                 /* rtt variation, ms x 4            */
+	Word		rto;                    /* retransmit timeout, ms           */
+	short		backoff;                /* timeouts in a row                */
+	short		dupacks;                /* duplicate acks in a row          */
+	Longword	snd_push;               /* flushed up to here, Nagle or not */
+	Longword	ack_time;               /* delayed ack goes, 0 = none owed  */
+	Longword	reo_time;               /* too few dupacks, resend anyway   */
+	short		ackdue;                 /* segments in that we haven't acked*/
+	short		nodelay;                /* True = small writes go at once   */
 	Longword	timeout;		        /* timeout, in milliseconds         */
 	short		unhappy;		        /* flag, retransmitting segt's      */
 	Word		flags;			        /* flags Word for last packet sent  */
-	short		dataSize;		        /* number of bytes of data to send  */
+	short		dataSize;		        /* bytes in data, sent and unsent   */
 	Byte		data[ TCP_MAXDATA ];    /* data to send                     */
+	struct in_Header  iphdr;	        /* IP header template, see tcp_Send */
+	struct tcp_Header tcphdr;	        /* TCP header template              */
 } ;
 
 /* ----- ARP definitions --------------------------------------------------- */
@@ -201,6 +292,14 @@ struct tcp_Socket {
 #define ARP_REQUEST	    1       /* harp op codes */
 #define ARP_REPLY	    2
 
+#define ARP_TABSIZE	16			/* addresses we keep                     */
+#define ARP_QUEUE	2			/* frames waiting on a reply             */
+#define ARP_QDATA	1500		/* biggest frame that waits, less header */
+#define ARP_RETRY	250L		/* ms between requests                   */
+#define ARP_TRIES	8			/* requests before we give up on him     */
+#define ARP_REFRESH	540000L		/* ask again when this old, 9 minutes    */
+#define ARP_MAXAGE	600000L		/* and throw it out at 10                */
+
 struct arp_Header {
 	Word		hwType;
 	Word		protType;
@@ -236,7 +335,7 @@ struct icmp_packet {
 /* ----- TCP Timer definitions ----------------------------------------------*/
 #define ETHERNET 1
 #if     ETHERNET					/* ETHERNET VALUES */
-#define tcp_RETRANSMITTIME  1000L  	/* interval retransmitter is called 1sec */
+#define tcp_RETRANSMITTIME   100L  	/* interval retransmitter is called 0.1s */
 #define tcp_LONGTIMEOUT    20000L   /* timeout for opens 					 */
 #define tcp_TIMEOUT	       20000L   /* timeout during a connection 			 */
 #else
@@ -245,9 +344,23 @@ struct icmp_packet {
 #define tcp_TIMEOUT	       20000    /* timeout during a connection 			 */
 #endif
 
+/* ----- TCP retransmit timeout, see tcp_RttUpdate -------------------------- */
+#define TCP_INITRTO	1000	/* rto before there is an rtt sample, ms         */
+#define TCP_MINRTO	 300	/* never less than this, ms                      */
+#define TCP_MAXRTO	60000U	/* nor more than this, ms                        */
+#define TCP_MAXRTX	8		/* timeouts in a row before giving up            */
+#define TCP_DUPACKS	3		/* duplicate acks that set off a fast retransmit */
+#define TCP_REOWAIT	10		/* ms fewer of them wait for more, at least      */
+#define TCP_ACKDELAY 40		/* ms an ack waits for data to go out on         */
+#define TCP_ACKEVERY 2		/* segments in before an ack goes anyway         */
+
 /* ----- function prototype definitions ------------------------------------ */
 #include "proto.h"
 
+#ifdef __GNUC__
+#pragma pack(pop)
+#endif
+
 /* ----- end of tinytcp.h -------------------------------------------------- */
 
 